@@ -0,0 +1,101 @@
+#include "../include/KNearestNeighbours.h"
+#include "../include/MachineData.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// KD-tree against brute-force kNN queries on a synthetic reference set drawn
+// from data/machine.data: rows are resampled and every predictor is jittered
+// by a log-normal factor, so the reference set keeps the real marginals.
+//
+//     knnBench [reference rows] [queries] [k]
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+double seconds_since(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+MachineData jittered(const MachineData& source, size_t rows, mt19937_64& rng) {
+    uniform_int_distribution<size_t> pick(0, source.rows() - 1);
+    lognormal_distribution<double> jitter(0.0, 0.1);
+    MachineData data;
+    data.features.resize(rows * MachineData::kNumFeatures);
+    data.targets.resize(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        size_t s = pick(rng);
+        for (int j = 0; j < MachineData::kNumFeatures; ++j) {
+            data.features[i * MachineData::kNumFeatures + j] = source.row(s)[j] * jitter(rng);
+        }
+        data.targets[i] = source.targets[s] * jitter(rng);
+    }
+    return data;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    try {
+        size_t rows = argc > 1 ? stoul(argv[1]) : 1000000;
+        size_t queries = argc > 2 ? stoul(argv[2]) : 1000;
+        int k = argc > 3 ? stoi(argv[3]) : 5;
+
+        MachineData source = read_machine_data("data/machine.data");
+        if (source.rows() == 0)
+            throw runtime_error("No rows in data/machine.data.");
+        mt19937_64 rng(42);
+        MachineData reference = jittered(source, rows, rng);
+        MachineData query = jittered(source, queries, rng);
+
+        auto start = Clock::now();
+        KNearestNeighbours knn(reference, k);
+        printf("%zu reference rows, k = %d: index built in %.3f s\n", rows, k, seconds_since(start));
+
+        typedef KNearestNeighbours::Search Search;
+        start = Clock::now();
+        vector<double> brute = knn.predict(query.features.data(), queries, Search::BruteForce);
+        double bruteTime = seconds_since(start);
+        start = Clock::now();
+        vector<double> tree = knn.predict(query.features.data(), queries, Search::KdTree);
+        double treeTime = seconds_since(start);
+
+        // Ties at the k-th distance may pick different rows; compare distances.
+        size_t mismatches = 0;
+        vector<size_t> ia(k), ib(k);
+        vector<double> da(k), db(k);
+        for (size_t q = 0; q < queries; ++q) {
+            knn.neighbours(query.row(q), ia.data(), da.data(), Search::BruteForce);
+            knn.neighbours(query.row(q), ib.data(), db.data(), Search::KdTree);
+            for (int i = 0; i < k; ++i) {
+                if (da[i] != db[i]) {
+                    ++mismatches;
+                    break;
+                }
+            }
+        }
+
+        printf("brute force: %8.3f s  (%9.1f us/query, %.2f Grows/s)\n",
+               bruteTime, 1e6 * bruteTime / queries, rows * queries / bruteTime / 1e9);
+        printf("KD-tree:     %8.3f s  (%9.1f us/query), speed-up %.1fx\n",
+               treeTime, 1e6 * treeTime / queries, bruteTime / treeTime);
+        double maxDiff = 0.0;
+        for (size_t q = 0; q < queries; ++q) maxDiff = max(maxDiff, fabs(brute[q] - tree[q]));
+        printf("queries whose neighbour distances differ: %zu of %zu (max prediction difference %g)\n",
+               mismatches, queries, maxDiff);
+    } catch (const exception& e) {
+        cerr << "Exception: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
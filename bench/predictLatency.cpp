@@ -0,0 +1,99 @@
+#include "../include/MachineData.h"
+#include "../include/Matrix.h"
+#include "../include/Model.h"
+#include "../include/NormalEquations.h"
+#include "../include/Regression.h"
+#include "../include/Vector.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Single-row prediction latency: Model::predictOne against Model::predict and
+// the Matrix/Vector predict() used by tinyProject. Each call is timed on its
+// own and the steady_clock overhead (median of empty timings) is subtracted.
+//
+//     predictLatency [model file] [calls]
+//
+// Without a model file one is trained on data/machine.data.
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+volatile double gSink; // keeps the predictions alive
+
+double clock_overhead_ns() {
+    vector<double> samples(100000);
+    for (double& s : samples) {
+        auto t0 = Clock::now();
+        auto t1 = Clock::now();
+        s = chrono::duration<double, nano>(t1 - t0).count();
+    }
+    nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+// Times fn(row) for `calls` calls cycling over the rows and prints percentiles.
+template <typename Fn>
+void measure(const string& label, const MachineData& data, size_t calls, double overhead, Fn fn) {
+    for (size_t i = 0; i < 10000; ++i) gSink = fn(data.row(i % data.rows())); // warm up
+
+    vector<double> samples(calls);
+    for (size_t i = 0; i < calls; ++i) {
+        const double* x = data.row(i % data.rows());
+        auto t0 = Clock::now();
+        double y = fn(x);
+        auto t1 = Clock::now();
+        gSink = y;
+        samples[i] = max(0.0, chrono::duration<double, nano>(t1 - t0).count() - overhead);
+    }
+    sort(samples.begin(), samples.end());
+    auto pct = [&](double q) {return samples[min(calls - 1, static_cast<size_t>(q * calls))];};
+    printf("%-24s p50 %8.1f ns   p99 %8.1f ns   p999 %8.1f ns   max %10.1f ns\n",
+           label.c_str(), pct(0.5), pct(0.99), pct(0.999), samples.back());
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    try {
+        MachineData data = read_machine_data("data/machine.data");
+        if (data.rows() == 0)
+            throw runtime_error("No rows in data/machine.data.");
+        size_t calls = argc > 2 ? stoul(argv[2]) : 1000000;
+
+        vector<string> names(MachineData::kColumnNames, MachineData::kColumnNames + MachineData::kNumFeatures);
+        NormalEquationsAccumulator normal(MachineData::kNumFeatures);
+        normal.addRows(data.features.data(), data.targets.data(), data.rows());
+        Model model = argc > 1 ? Model::load(argv[1]) : Model(names, normal.solve());
+        if (model.nFeatures() != MachineData::kNumFeatures)
+            throw runtime_error("predictOne needs a model with " + to_string(MachineData::kNumFeatures) + " features.");
+        Vector weights(model.nFeatures());
+        for (int j = 0; j < model.nFeatures(); ++j) weights[j] = model.effectiveWeights()[j];
+
+        double overhead = clock_overhead_ns();
+        printf("%zu calls, clock overhead %.1f ns subtracted\n", calls, overhead);
+
+        measure("Model::predictOne", data, calls, overhead,
+                [&](const double* x) {return model.predictOne(x);});
+        measure("Model::predict", data, calls, overhead,
+                [&](const double* x) {return model.predict(x);});
+        measure("predict(Matrix, Vector)", data, min<size_t>(calls, 200000), overhead,
+                [&](const double* x) {
+                    Matrix X(1, MachineData::kNumFeatures);
+                    for (int j = 0; j < MachineData::kNumFeatures; ++j) X[0][j] = x[j];
+                    return predict(X, weights)[0] + model.effectiveBias();
+                });
+    } catch (const exception& e) {
+        cerr << "Exception: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
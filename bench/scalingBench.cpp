@@ -0,0 +1,116 @@
+#include "../include/DatasetCache.h"
+#include "../include/Evaluation.h"
+#include "../include/MachineData.h"
+#include "../include/Model.h"
+#include "../include/NormalEquations.h"
+#include "../include/Parallel.h"
+#include "../include/SyntheticData.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Scaling of the regression pipeline on synthetic machine.data rows: for
+// 10³, 10⁴, ... rows it generates a CSV, parses it, fits least squares with
+// per-thread normal equations, and scores every row (predict and RMSE in one
+// pass). It also writes the same rows as a dataset cache and opens it, the
+// path that skips the CSV parse, and fits and scores from a cache of the
+// parsed rows, whose integer columns are bit-packed and decoded block by
+// block (cfit, cscore).
+//
+//     scalingBench [max rows] [seed] [directory]
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+double seconds_since(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+const vector<string> kFeatureNames(MachineData::kColumnNames, MachineData::kColumnNames + MachineData::kNumFeatures);
+
+Model fit(const MachineData& data) {
+    NormalEquationsAccumulator empty(MachineData::kNumFeatures);
+    unsigned workers = worker_count(data.rows(), 0);
+    vector<NormalEquationsAccumulator> parts(workers, empty);
+    parallel_ranges(data.rows(), workers, [&](size_t begin, size_t end, unsigned w) {
+        parts[w].addRows(data.row(begin), &data.targets[begin], end - begin);
+    });
+    for (auto& part : parts) empty.merge(part);
+    return Model(kFeatureNames, empty.solve());
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    try {
+        size_t maxRows = argc > 1 ? stoull(argv[1]) : 10000000;
+        uint64_t seed = argc > 2 ? stoull(argv[2]) : 42;
+        filesystem::path dir = argc > 3 ? filesystem::path(argv[3]) : filesystem::temp_directory_path();
+        string csvPath = (dir / "scalingBench.csv").string();
+        string cachePath = (dir / "scalingBench.tpcache").string();
+        string packedPath = (dir / "scalingBench.packed.tpcache").string();
+
+        printf("%11s %9s %9s %9s %9s %9s %9s %9s %9s %9s %10s\n", "rows", "gen s", "MB/s", "parse s", "fit s",
+               "score s", "cache s", "open s", "cfit s", "cscore s", "RMSE");
+        for (size_t rows = 1000; rows <= maxRows; rows *= 10) {
+            auto start = Clock::now();
+            write_synthetic_csv(csvPath, rows, seed);
+            double genTime = seconds_since(start);
+            double mb = filesystem::file_size(csvPath) / 1e6;
+
+            start = Clock::now();
+            MachineData data = read_machine_data(csvPath);
+            double parseTime = seconds_since(start);
+            if (data.rows() != rows)
+                throw runtime_error("Parsed " + to_string(data.rows()) + " of " + to_string(rows) + " rows.");
+
+            start = Clock::now();
+            Model model = fit(data);
+            double fitTime = seconds_since(start);
+
+            start = Clock::now();
+            RegressionMetrics metrics = evaluate_regression(data, model);
+            double scoreTime = seconds_since(start);
+
+            start = Clock::now();
+            write_synthetic_cache(cachePath, rows, seed);
+            double cacheTime = seconds_since(start);
+            start = Clock::now();
+            size_t cachedRows = DatasetCache(cachePath).rows();
+            double openTime = seconds_since(start);
+            if (cachedRows != rows)
+                throw runtime_error("Dataset cache holds " + to_string(cachedRows) + " rows.");
+
+            write_dataset_cache(packedPath, data, stamp_file(csvPath));
+            DatasetCache packed(packedPath);
+            start = Clock::now();
+            Model packedModel(kFeatureNames, accumulate_dataset_cache(packed).solve());
+            double cacheFitTime = seconds_since(start);
+            start = Clock::now();
+            RegressionMetrics packedMetrics = evaluate_regression(packed, packedModel);
+            double cacheScoreTime = seconds_since(start);
+            if (fabs(packedMetrics.rmse - metrics.rmse) > 1e-6 * metrics.rmse)
+                throw runtime_error("RMSE from the packed cache differs: " + to_string(packedMetrics.rmse));
+
+            printf("%11zu %9.4f %9.1f %9.4f %9.4f %9.4f %9.4f %9.4f %9.4f %9.4f %10.4f\n", rows, genTime,
+                   mb / genTime, parseTime, fitTime, scoreTime, cacheTime, openTime, cacheFitTime, cacheScoreTime,
+                   metrics.rmse);
+        }
+        filesystem::remove(csvPath);
+        filesystem::remove(cachePath);
+        filesystem::remove(packedPath);
+    } catch (const exception& e) {
+        cerr << "Exception: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,293 @@
+#include "../include/LinearSystem.h"
+#include "../include/MachineData.h"
+#include "../include/Matrix.h"
+#include "../include/Regression.h"
+#include "../include/SyntheticData.h"
+#include "../include/Vector.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Benchmark suite for the Vector/Matrix classes, the linear solvers and the
+// regression pipeline, with the same operation done by Eigen alongside. Each
+// case runs `warmup` untimed repetitions, then `reps` timed ones, and reports
+// the median. GFLOP/s use the textbook operation count (2n³/3 for an LU
+// determinant or solve, n³/3 for an SPD solve), so an algorithm that does more
+// work than that shows a lower effective rate; GB/s count each operand read or
+// written once.
+//
+//     tinyBench [--n vector length] [--m matrix order] [--small cofactor order]
+//               [--rows dataset rows] [--reps R] [--warmup W] [--filter text]
+//               [--json path]
+
+namespace {
+
+typedef chrono::steady_clock Clock;
+
+volatile double gSink; // keeps results alive
+
+struct BenchResult
+{
+    string name;
+    string impl;
+    string size;
+    int reps;
+    double median; // seconds
+    double min;
+    double flops;  // per repetition, 0 when not meaningful
+    double bytes;
+};
+
+class BenchRunner
+{
+private:
+    int mWarmup;
+    int mReps;
+    string mFilter;
+    vector<BenchResult> mResults;
+
+public:
+    BenchRunner(int warmup, int reps, const string& filter): mWarmup(warmup), mReps(reps), mFilter(filter) {}
+
+    template <typename Fn>
+    void run(const string& name, const string& impl, const string& size, double flops, double bytes, Fn fn) {
+        if (!mFilter.empty() && name.find(mFilter) == string::npos) return;
+        for (int r = 0; r < mWarmup; ++r) fn();
+
+        vector<double> times(mReps);
+        for (int r = 0; r < mReps; ++r) {
+            auto start = Clock::now();
+            fn();
+            times[r] = chrono::duration<double>(Clock::now() - start).count();
+        }
+        sort(times.begin(), times.end());
+        BenchResult result = {name, impl, size, mReps, times[mReps / 2], times[0], flops, bytes};
+        mResults.push_back(result);
+        print(result);
+    }
+
+    void writeJson(const string& path) const;
+
+private:
+    static void print(const BenchResult& r);
+};
+
+void BenchRunner::print(const BenchResult& r) {
+    printf("%-16s %-6s %-14s %12.3f us", r.name.c_str(), r.impl.c_str(), r.size.c_str(), 1e6 * r.median);
+    if (r.flops > 0) printf(" %9.4g GFLOP/s", r.flops / r.median / 1e9);
+    else printf(" %17s", "");
+    if (r.bytes > 0) printf(" %9.4g GB/s", r.bytes / r.median / 1e9);
+    printf("\n");
+}
+
+void BenchRunner::writeJson(const string& path) const {
+    ofstream out(path);
+    if (!out)
+        throw runtime_error("Could not create file: " + path);
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < mResults.size(); ++i) {
+        const BenchResult& r = mResults[i];
+        char line[512];
+        snprintf(line, sizeof(line),
+                 "    {\"name\": \"%s\", \"impl\": \"%s\", \"size\": \"%s\", \"reps\": %d, "
+                 "\"median_s\": %.9g, \"min_s\": %.9g, \"gflops\": %.6g, \"gbps\": %.6g}%s\n",
+                 r.name.c_str(), r.impl.c_str(), r.size.c_str(), r.reps, r.median, r.min,
+                 r.flops > 0 ? r.flops / r.median / 1e9 : 0.0, r.bytes > 0 ? r.bytes / r.median / 1e9 : 0.0,
+                 i + 1 < mResults.size() ? "," : "");
+        out << line;
+    }
+    out << "  ]\n}\n";
+    if (!out)
+        throw runtime_error("Could not write file: " + path);
+}
+
+Matrix random_matrix(int rows, int cols, mt19937_64& rng) {
+    uniform_real_distribution<double> u(-1.0, 1.0);
+    Matrix A(rows, cols);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) A[i][j] = u(rng);
+    }
+    return A;
+}
+
+Vector random_vector(int size, mt19937_64& rng) {
+    uniform_real_distribution<double> u(-1.0, 1.0);
+    Vector v(size);
+    for (int i = 0; i < size; ++i) v[i] = u(rng);
+    return v;
+}
+
+Eigen::MatrixXd to_eigen(const Matrix& A) {
+    Eigen::MatrixXd E(A.nRows(), A.nCols());
+    for (int i = 0; i < A.nRows(); ++i) {
+        for (int j = 0; j < A.nCols(); ++j) E(i, j) = A[i][j];
+    }
+    return E;
+}
+
+Eigen::VectorXd to_eigen(const Vector& v) {
+    Eigen::VectorXd E(v.size());
+    for (int i = 0; i < v.size(); ++i) E(i) = v[i];
+    return E;
+}
+
+// Diagonally dominant, so Gaussian elimination and CG are well conditioned.
+Matrix spd_matrix(int n, mt19937_64& rng) {
+    Matrix B = random_matrix(n, n, rng);
+    Matrix A(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) A[i][j] = 0.5 * (B[i][j] + B[j][i]);
+        A[i][i] += n;
+    }
+    return A;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    try {
+        int n = 1 << 20, m = 256, small = 8, reps = 11, warmup = 2;
+        size_t rows = 1000000;
+        string filter, jsonPath;
+        for (int a = 1; a < argc; ++a) {
+            string arg = argv[a];
+            if (a + 1 >= argc)
+                throw runtime_error("Missing value for " + arg);
+            string value = argv[++a];
+            if (arg == "--n") n = stoi(value);
+            else if (arg == "--m") m = stoi(value);
+            else if (arg == "--small") small = stoi(value);
+            else if (arg == "--rows") rows = stoull(value);
+            else if (arg == "--reps") reps = stoi(value);
+            else if (arg == "--warmup") warmup = stoi(value);
+            else if (arg == "--filter") filter = value;
+            else if (arg == "--json") jsonPath = value;
+            else throw runtime_error("Unknown option " + arg);
+        }
+        if (n < 1 || m < 1 || small < 1 || reps < 1 || warmup < 0)
+            throw runtime_error("Sizes and repetitions must be positive.");
+
+        BenchRunner bench(warmup, reps, filter);
+        mt19937_64 rng(42);
+        const double dn = n, dm = m, ds = small;
+        const string nLabel = to_string(n), mLabel = to_string(m) + "x" + to_string(m);
+        const string sLabel = to_string(small) + "x" + to_string(small);
+
+        // Level 1
+        Vector x = random_vector(n, rng), y = random_vector(n, rng);
+        Eigen::VectorXd ex = to_eigen(x), ey = to_eigen(y);
+        bench.run("dot", "tiny", nLabel, 2 * dn, 16 * dn, [&] {gSink = x * y;});
+        bench.run("dot", "eigen", nLabel, 2 * dn, 16 * dn, [&] {gSink = ex.dot(ey);});
+        bench.run("axpy", "tiny", nLabel, 2 * dn, 24 * dn, [&] {Vector z = y + x * 0.5; gSink = z[0];});
+        bench.run("axpy", "eigen", nLabel, 2 * dn, 24 * dn, [&] {ey += 0.5 * ex; gSink = ey(0);});
+
+        // Level 2 and 3
+        Matrix A = random_matrix(m, m, rng), B = random_matrix(m, m, rng);
+        Vector v = random_vector(m, rng);
+        Eigen::MatrixXd eA = to_eigen(A), eB = to_eigen(B);
+        Eigen::VectorXd ev = to_eigen(v);
+        bench.run("gemv", "tiny", mLabel, 2 * dm * dm, 8 * dm * dm, [&] {Vector r = A * v; gSink = r[0];});
+        bench.run("gemv", "eigen", mLabel, 2 * dm * dm, 8 * dm * dm,
+                  [&] {Eigen::VectorXd r = eA * ev; gSink = r(0);});
+        bench.run("gemm", "tiny", mLabel, 2 * dm * dm * dm, 24 * dm * dm, [&] {Matrix C = A * B; gSink = C[0][0];});
+        bench.run("gemm", "eigen", mLabel, 2 * dm * dm * dm, 24 * dm * dm,
+                  [&] {Eigen::MatrixXd C = eA * eB; gSink = C(0, 0);});
+        bench.run("transpose", "tiny", mLabel, 0, 16 * dm * dm, [&] {Matrix T = A.transpose(); gSink = T[0][0];});
+        bench.run("transpose", "eigen", mLabel, 0, 16 * dm * dm,
+                  [&] {Eigen::MatrixXd T = eA.transpose(); gSink = T(0, 0);});
+
+        // Cofactor expansion is O(n!), so det and inverse get their own order.
+        Matrix S = spd_matrix(small, rng);
+        Eigen::MatrixXd eS = to_eigen(S);
+        bench.run("det", "tiny", sLabel, 2 * ds * ds * ds / 3, 8 * ds * ds, [&] {gSink = S.det();});
+        bench.run("det", "eigen", sLabel, 2 * ds * ds * ds / 3, 8 * ds * ds,
+                  [&] {gSink = eS.partialPivLu().determinant();});
+        bench.run("inverse", "tiny", sLabel, 2 * ds * ds * ds, 16 * ds * ds,
+                  [&] {Matrix I = S.inverse(); gSink = I[0][0];});
+        bench.run("inverse", "eigen", sLabel, 2 * ds * ds * ds, 16 * ds * ds,
+                  [&] {Eigen::MatrixXd I = eS.inverse(); gSink = I(0, 0);});
+
+        // Solvers
+        Matrix P = spd_matrix(m, rng);
+        Eigen::MatrixXd eP = to_eigen(P);
+        bench.run("gauss", "tiny", mLabel, 2 * dm * dm * dm / 3, 8 * dm * dm, [&] {
+            LinearSystem system(P, v);
+            Vector r = system.Solve();
+            gSink = r[0];
+        });
+        bench.run("gauss", "eigen", mLabel, 2 * dm * dm * dm / 3, 8 * dm * dm,
+                  [&] {Eigen::VectorXd r = eP.partialPivLu().solve(ev); gSink = r(0);});
+        bench.run("cg", "tiny", mLabel, dm * dm * dm / 3, 8 * dm * dm, [&] {
+            PosSymLinSystem system(P, v);
+            Vector r = system.Solve();
+            gSink = r[0];
+        });
+        bench.run("cg", "eigen", mLabel, dm * dm * dm / 3, 8 * dm * dm,
+                  [&] {Eigen::VectorXd r = eP.llt().solve(ev); gSink = r(0);});
+        Matrix R = random_matrix(2 * m, m, rng);
+        Eigen::MatrixXd eR = to_eigen(R);
+        const string rLabel = to_string(2 * m) + "x" + to_string(m);
+        bench.run("pinv", "tiny", rLabel, 0, 32 * dm * dm, [&] {Matrix Q = R.pseudo_inverse(); gSink = Q[0][0];});
+        bench.run("pinv", "eigen", rLabel, 0, 32 * dm * dm,
+                  [&] {Eigen::MatrixXd Q = eR.completeOrthogonalDecomposition().pseudoInverse(); gSink = Q(0, 0);});
+
+        // Regression pipeline on synthetic machine.data rows
+        string csvPath = (filesystem::temp_directory_path() / "tinyBench.csv").string();
+        write_synthetic_csv(csvPath, rows, 42);
+        const double csvBytes = static_cast<double>(filesystem::file_size(csvPath));
+        const string rowLabel = to_string(rows);
+        bench.run("csv-parse", "tiny", rowLabel, 0, csvBytes,
+                  [&] {gSink = static_cast<double>(read_machine_data(csvPath).rows());});
+        MachineData data = read_machine_data(csvPath);
+        filesystem::remove(csvPath);
+
+        const int p = MachineData::kNumFeatures;
+        const double dr = static_cast<double>(data.rows());
+        Matrix X(static_cast<int>(data.rows()), p);
+        Vector Y(static_cast<int>(data.rows()));
+        for (size_t i = 0; i < data.rows(); ++i) {
+            copy(data.row(i), data.row(i) + p, X[i]);
+            Y[i] = data.targets[i];
+        }
+        Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+            eX(data.features.data(), data.rows(), p);
+        Eigen::Map<const Eigen::VectorXd> eY(data.targets.data(), data.rows());
+
+        Vector w = solve_linear_regression(X, Y);
+        Eigen::VectorXd ew = to_eigen(w);
+        bench.run("fit", "tiny", rowLabel, 2 * dr * p * p, 8 * dr * (p + 1), [&] {
+            Vector r = solve_linear_regression(X, Y);
+            gSink = r[0];
+        });
+        bench.run("fit", "eigen", rowLabel, 2 * dr * p * p, 8 * dr * (p + 1), [&] {
+            Eigen::MatrixXd G = Eigen::MatrixXd::Zero(p, p);
+            G.selfadjointView<Eigen::Lower>().rankUpdate(eX.transpose());
+            Eigen::VectorXd r = G.selfadjointView<Eigen::Lower>().llt().solve(eX.transpose() * eY);
+            gSink = r(0);
+        });
+        bench.run("predict", "tiny", rowLabel, 2 * dr * p, 8 * dr * (p + 1),
+                  [&] {Vector r = predict(X, w); gSink = r[0];});
+        bench.run("predict", "eigen", rowLabel, 2 * dr * p, 8 * dr * (p + 1),
+                  [&] {Eigen::VectorXd r = eX * ew; gSink = r(0);});
+
+        if (!jsonPath.empty()) {
+            bench.writeJson(jsonPath);
+            cout << "Results written to " << jsonPath << endl;
+        }
+    } catch (const exception& e) {
+        cerr << "Exception: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Frame-of-reference bit packing for integer valued columns. Every value is
+// stored as (value - reference) in bitWidth bits, reference being the column
+// minimum. Values are packed in blocks of kBitPackBlock: inside a block, value
+// i goes to lane i % kBitPackLanes and each lane is a little-endian bit stream
+// of 32-bit words, with the words of the lanes interleaved. Decoding therefore
+// shifts and masks kBitPackLanes values with the same shift at once, which the
+// compiler turns into vector instructions. A block of any width takes exactly
+// bitWidth * kBitPackLanes words; the last block is zero padded.
+
+const size_t kBitPackLanes = 8;
+const size_t kBitPackBlock = 32 * kBitPackLanes;
+
+// Finds reference and bitWidth for values. Returns false when a value is not an
+// integer or the range does not fit in 32 bits.
+bool bitpack_plan(const double* values, size_t count, int64_t& reference, int& bitWidth);
+
+size_t bitpack_blocks(size_t count);
+size_t bitpack_words(size_t count, int bitWidth);
+
+void bitpack_encode(const double* values, size_t count, int64_t reference, int bitWidth, uint32_t* words);
+
+// Decodes numBlocks whole blocks starting at firstBlock into out, which must
+// have room for numBlocks * kBitPackBlock values.
+void bitpack_decode(const uint32_t* words, int64_t reference, int bitWidth,
+                    size_t firstBlock, size_t numBlocks, double* out);
+
+// Decodes the single value at index, for random access without a block buffer.
+double bitpack_get(const uint32_t* words, int64_t reference, int bitWidth, size_t index);
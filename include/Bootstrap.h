@@ -0,0 +1,34 @@
+#pragma once
+
+#include "MachineData.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bootstrap confidence intervals for the least squares weights.
+//
+// A replicate draws n row indices with replacement; a row drawn c_i times
+// enters its normal equations with weight c_i,
+//     Σ c_i x_i x_iᵀ w = Σ c_i x_i y_i.
+// Every draw goes straight from data.row(i) into the replicate's
+// NormalEquationsAccumulator, whose batches of drawn rows become rank-k
+// updates, so neither the counts nor any copy of the rows is stored and a
+// replicate needs O(p²) memory. Replicates are split across threads. Each
+// replicate has its own RNG stream seeded from (seed, replicate), so the
+// result does not depend on the number of threads.
+
+struct BootstrapResult
+{
+    std::vector<double> estimate;      // fit on the original rows
+    std::vector<double> weights;       // successful replicates, row-major replicates x p
+    std::vector<double> lower, upper;  // percentile interval of each weight
+    std::vector<double> standardError; // standard deviation over the replicates
+    size_t replicates;                 // successful replicates
+    size_t failed;                     // replicates whose XᵀX was singular
+};
+
+BootstrapResult bootstrap_weights(const MachineData& data, int numReplicates, double confidence = 0.95,
+                                  uint64_t seed = 42, unsigned numThreads = 0);
+
+// Linearly interpolated q-quantile of sorted values.
+double sorted_quantile(const std::vector<double>& sorted, double q);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+#include <vector>
+
+// Cholesky factorisation A = L Lᵀ of a symmetric positive definite matrix.
+// Only the lower triangle of A is read. The factor is kept, so one
+// factorisation can serve any number of right-hand sides.
+
+class Cholesky
+{
+private:
+    int mSize;
+    std::vector<double> mL; // row-major mSize x mSize, lower triangle used
+    std::vector<double> mWork; // scratch for rank-one updates
+
+public:
+    explicit Cholesky(const Matrix& A);
+    Cholesky(const double* A, int size); // A row-major size x size
+
+    int size() const {return mSize;}
+    const double* factor() const {return mL.data();}
+
+    Vector Solve(const Vector& b) const;
+    void solveInPlace(double* x) const;   // x <- A⁻¹ x
+    void forwardInPlace(double* x) const; // x <- L⁻¹ x
+    void backwardInPlace(double* x) const; // x <- L⁻ᵀ x
+    // B <- A⁻¹ B for numRhs right-hand sides at once, B row-major size x numRhs;
+    // the inner loops run across the right-hand sides.
+    void solveInPlace(double* B, int numRhs) const;
+
+    // O(n²) modifications of the factored matrix, keeping L lower triangular.
+    void update(const double* x);   // A <- A + x xᵀ
+    void downdate(const double* x); // A <- A - x xᵀ, throws if A would lose definiteness
+    void scale(double factor);      // A <- factor A, factor > 0
+
+private:
+    void factorise();
+    void rankOne(const double* x, double sign);
+    Cholesky() = delete;
+};
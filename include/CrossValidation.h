@@ -0,0 +1,46 @@
+#pragma once
+
+#include "MachineData.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// k-fold cross-validation of the least squares fit. Each fold's XᵀX and Xᵀy
+// are accumulated once (one pass over the data, folds in parallel); the
+// training system of fold f is then "total minus fold f", which costs O(p²)
+// instead of another pass over the rows. The held-out error of a fold also
+// comes from its sufficient statistics. Folds are solved in parallel.
+
+struct CrossValidationResult
+{
+    std::vector<double> foldRmse;
+    std::vector<size_t> foldRows;
+    double rmse;     // pooled over every held-out row
+    double meanRmse; // average of the fold RMSEs
+};
+
+// Fold of every row as a label: row i is in fold f exactly when it is in
+// DatasetSplit(numRows, ·, seed).fold(f, numFolds), so both APIs give the
+// same partition for the same seed and fold sizes differ by at most one.
+std::vector<int> assign_folds(size_t numRows, int numFolds, uint64_t seed);
+
+CrossValidationResult k_fold_cross_validation(const MachineData& data, int numFolds, uint64_t seed,
+                                              unsigned numThreads = 0);
+
+// Leave-one-out cross-validation in closed form. With the full fit w and the
+// leverages hᵢᵢ = xᵢᵀ(XᵀX)⁻¹xᵢ, the residual of row i under the model fitted
+// without it is (yᵢ - xᵢᵀw) / (1 - hᵢᵢ). One Cholesky factorisation LLᵀ = XᵀX
+// serves every row: hᵢᵢ = |L⁻¹xᵢ|², evaluated for a batch of rows at a time
+// with the batch laid across the inner loop so it vectorises. Total cost is
+// O(np²) rather than n refits. A row with hᵢᵢ within 1e-8 of 1 would divide
+// by nearly zero and is refitted by a Cholesky downdate instead; if the row
+// alone determines a direction of the fit (hᵢᵢ = 1) leave_one_out throws.
+
+struct LeaveOneOutResult
+{
+    std::vector<double> residuals; // yᵢ minus the prediction made without row i
+    std::vector<double> leverage;  // hᵢᵢ
+    double rmse;                   // sqrt(PRESS / n)
+};
+
+LeaveOneOutResult leave_one_out(const MachineData& data, unsigned numThreads = 0);
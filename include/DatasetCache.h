@@ -0,0 +1,114 @@
+#pragma once
+
+#include "BitPacking.h"
+#include "MachineData.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Binary columnar cache of a parsed machine.data file, so later runs can skip
+// the CSV parse. Layout (little-endian):
+//   - 64-byte header: magic "TPCACHE1", version, column count, row count and
+//     the size, mtime and hash of the source file it was built from;
+//   - one 64-byte descriptor per column: name, offset, length and optional
+//     min/max. The columns are the predictors, PRP, ERP and, when the
+//     vendors are known, VENDOR holding each row's vendor code;
+//   - the column blocks, each starting on a 64-byte boundary: either a float64
+//     array or, for integer columns, frame-of-reference bit-packed values (see
+//     BitPacking.h), which is 4-8x smaller for the machine.data columns;
+//   - the vendor names, '\n' separated, located by the header.
+// Opening a cache maps the file and decodes nothing: float64 columns are views
+// into the mapping and packed columns stay packed, decoded a block at a time
+// into the reader's buffer, so resident memory is the size of the file.
+
+// Identity of a source file; a cache is stale when any field differs. The hash
+// covers the first and last 64 KiB so that checking it stays cheap for large
+// files.
+struct SourceStamp
+{
+    uint64_t size;
+    int64_t mtime;
+    uint64_t hash;
+
+    bool operator==(const SourceStamp& other) const;
+};
+
+SourceStamp stamp_file(const std::string& path);
+
+// Rows per block handed out by ColumnView::block.
+const size_t kColumnBlockRows = kBitPackBlock;
+
+// Zero-copy view of one cached column.
+struct ColumnView
+{
+    const char* name;
+    size_t size;
+    bool hasRange;
+    double min;
+    double max;
+    bool packed;
+    const double* data;    // float64 values; nullptr when packed
+    const uint32_t* words; // packed blocks, reference and bit width (see BitPacking.h)
+    int64_t reference;
+    int bitWidth;
+
+    // Random access; a packed value is decoded on its own.
+    double operator[](size_t index) const {
+        return packed ? bitpack_get(words, reference, bitWidth, index) : data[index];
+    }
+
+    size_t numBlocks() const {return bitpack_blocks(size);}
+    // Rows [index * kColumnBlockRows, min(size, (index + 1) * kColumnBlockRows)):
+    // a pointer into the mapping for a float64 column, or buffer, which must
+    // hold kColumnBlockRows values, with the block decoded into it.
+    const double* block(size_t index, double* buffer) const;
+};
+
+class DatasetCache
+{
+private:
+    MappedFile mFile;
+    size_t mNumRows;
+    SourceStamp mStamp;
+    std::vector<ColumnView> mColumns;
+    std::vector<std::string> mVendorNames;
+
+public:
+    // Opens an existing cache file.
+    explicit DatasetCache(const std::string& cachePath);
+    // Opens the cache of sourcePath, (re)building it from the CSV first when it
+    // is missing or was built from a different version of the source.
+    DatasetCache(const std::string& sourcePath, const std::string& cachePath);
+
+    size_t rows() const {return mNumRows;}
+    int nColumns() const {return static_cast<int>(mColumns.size());}
+    const SourceStamp& source() const {return mStamp;}
+    const std::vector<std::string>& vendorNames() const {return mVendorNames;} // by VENDOR code
+
+    const ColumnView& column(int index) const;
+    const ColumnView& column(const std::string& name) const;
+
+private:
+    void load(const std::string& cachePath);
+    DatasetCache() = delete;
+    DatasetCache(const DatasetCache&) = delete;
+};
+
+// Writes data as a cache file tagged with the given source identity. The file
+// is written under a temporary name and renamed into place.
+void write_dataset_cache(const std::string& cachePath, const MachineData& data, const SourceStamp& source);
+
+// Fills rows [begin, end) of every column; columns[c] points at row begin of
+// column c.
+typedef std::function<void(size_t begin, size_t end, double* const* columns)> ColumnBlockFn;
+
+// Writes numRows rows of float64 columns without holding them in memory, for
+// generated datasets: fill is called for blocks of rows on up to numThreads
+// threads and each block goes straight to its final offset in the file. The
+// source identity is left zero, so open the result with DatasetCache(cachePath).
+void write_dataset_cache(const std::string& cachePath, size_t numRows, const std::vector<std::string>& columnNames,
+                         const std::vector<std::string>& vendorNames, const ColumnBlockFn& fill,
+                         unsigned numThreads = 0);
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Reproducible train/test splits as index permutations. Rows are never moved:
+// a split shuffles a compact uint32 permutation of the row indices and hands
+// out subsets of it as views, which index the original column storage (the
+// dataset cache's columns or MachineData's rows).
+
+// Counter-based generator: the i-th output is the SplitMix64 finaliser applied
+// to seed + (i + 1)·γ, so a stream is fully determined by (seed, counter),
+// costs a few multiplies per draw and can be jumped to any position.
+class CounterRng
+{
+private:
+    uint64_t mSeed;
+    uint64_t mCounter;
+
+public:
+    typedef uint64_t result_type;
+
+    explicit CounterRng(uint64_t seed, uint64_t counter = 0): mSeed(seed), mCounter(counter) {}
+
+    static uint64_t at(uint64_t seed, uint64_t counter);
+    uint64_t operator()() {return at(mSeed, mCounter++);}
+
+    static constexpr uint64_t min() {return 0;}
+    static constexpr uint64_t max() {return UINT64_MAX;}
+};
+
+// A permutation of 0..numRows-1 from a Fisher-Yates shuffle driven by
+// CounterRng(seed). Bounded draws use Lemire's multiply-shift with rejection
+// on full 64-bit outputs, so every position is exactly equally likely.
+// numRows must be below 2³².
+std::vector<uint32_t> shuffled_indices(size_t numRows, uint64_t seed);
+
+// Read-only view of a contiguous part of an index permutation.
+class IndexView
+{
+private:
+    const uint32_t* mBegin;
+    size_t mSize;
+
+public:
+    IndexView(const uint32_t* begin, size_t size): mBegin(begin), mSize(size) {}
+
+    size_t size() const {return mSize;}
+    uint32_t operator[](size_t k) const {return mBegin[k];}
+    const uint32_t* begin() const {return mBegin;}
+    const uint32_t* end() const {return mBegin + mSize;}
+};
+
+// Shuffled rows cut into a training part (the first trainFraction of them,
+// rounded down) and a test part, or into k near-equal folds.
+class DatasetSplit
+{
+private:
+    std::vector<uint32_t> mOrder;
+    size_t mTrainRows;
+
+public:
+    DatasetSplit(size_t numRows, double trainFraction, uint64_t seed);
+
+    size_t rows() const {return mOrder.size();}
+    IndexView all() const {return IndexView(mOrder.data(), mOrder.size());}
+    IndexView train() const {return IndexView(mOrder.data(), mTrainRows);}
+    IndexView test() const {return IndexView(mOrder.data() + mTrainRows, mOrder.size() - mTrainRows);}
+
+    // Fold f of k: positions [f·n/k, (f+1)·n/k) of the permutation.
+    IndexView fold(int f, int k) const;
+
+private:
+    DatasetSplit() = delete;
+};
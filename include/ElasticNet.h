@@ -0,0 +1,40 @@
+#pragma once
+
+#include "NormalEquations.h"
+#include "Vector.h"
+#include <cstddef>
+#include <vector>
+
+// Elastic net by cyclic coordinate descent on the Gram matrix ("covariance
+// updates"), minimising
+//     |y - Xw|² / 2n + λ (α|w|₁ + (1 - α)|w|² / 2)
+// over columns scaled to unit root-mean-square. The gradient g = Xᵀy/n - Gw
+// is kept up to date, so a coordinate step that changes w_k costs O(p) and a
+// sweep over the active set costs O(p·active), independent of n.
+//
+// The path runs from λ_max (all weights zero) down to λ_max * minRatio with
+// warm starts. At each λ the sequential strong rule discards features with
+// |g_j| < α(2λ - λ_prev); sweeps then cycle over the non-zero (active) set
+// until it settles, followed by one pass over the strong set, and finally a
+// KKT check on the discarded features re-admits any rule violations.
+
+struct ElasticNetOptions
+{
+    double alpha = 1.0;     // 1 = lasso, 0 = ridge
+    int numLambdas = 100;
+    double minRatio = 1e-4; // smallest λ relative to λ_max
+    double tolerance = 1e-9;
+    int maxSweeps = 10000;
+};
+
+struct ElasticNetPath
+{
+    std::vector<double> lambdas;
+    std::vector<Vector> weights;        // original feature scale
+    std::vector<int> nonZeros;
+    std::vector<double> validationRmse; // empty without a validation set
+    size_t best;                        // lowest validation RMSE, else last λ
+};
+
+ElasticNetPath elastic_net_path(NormalEquationsAccumulator& train, const ElasticNetOptions& options,
+                                NormalEquationsAccumulator* validation = nullptr);
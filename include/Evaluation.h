@@ -0,0 +1,42 @@
+#pragma once
+
+#include "DatasetCache.h"
+#include "MachineData.h"
+#include "Matrix.h"
+#include "Model.h"
+#include "Vector.h"
+#include <cstddef>
+#include <vector>
+
+// Fused model evaluation: one multithreaded pass over X and Y that forms each
+// prediction ŷ_i = bias + x_iᵀw in registers and folds it straight into the
+// error metrics, so no prediction vector is ever stored.
+//
+// Squared and absolute errors are Kahan-summed in eight independent lanes per
+// worker; the target variance for R² uses Welford's update per lane, and the
+// lanes and workers are combined with Chan's parallel merge.
+
+struct RegressionMetrics
+{
+    size_t count = 0;
+    double rmse = 0.0;
+    double mae = 0.0;
+    double r2 = 0.0;       // 1 - SSE / Σ(y - ȳ)²; NaN when the targets are constant
+    double maxError = 0.0; // largest |ŷ - y|
+};
+
+// Rows of X against Y for a plain least squares weight vector (no intercept).
+RegressionMetrics evaluate_regression(const Matrix& X, const Vector& Y, const Vector& weights,
+                                      unsigned numThreads = 0);
+
+// Several targets in the same pass: X is read once and weights is p x t, one
+// column per target column of Y. Returns one set of metrics per target.
+std::vector<RegressionMetrics> evaluate_regression(const Matrix& X, const Matrix& Y, const Matrix& weights,
+                                                   unsigned numThreads = 0);
+
+// Every row of data against a saved model, including its normalisation.
+RegressionMetrics evaluate_regression(const MachineData& data, const Model& model, unsigned numThreads = 0);
+
+// The same over a dataset cache, the predictors and PRP pulled one column
+// block at a time so packed columns are never decoded whole.
+RegressionMetrics evaluate_regression(const DatasetCache& cache, const Model& model, unsigned numThreads = 0);
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "MachineData.h"
+#include "NormalEquations.h"
+#include "Vector.h"
+#include <string>
+#include <vector>
+
+// Polynomial, interaction and log features for the least squares fit,
+// expanded lazily: the expanded design matrix never exists. Base rows are
+// taken kBatchRows at a time, transposed into base columns, and every
+// expanded term of the batch (a product of up to three base columns) is
+// generated column by column straight into the batch that feeds the
+// accumulator's rank-k update, so memory stays O(terms²).
+//
+// Terms are an intercept, every monomial of degree 1..degree in the base
+// features (each divided by its root-mean-square so that MMAX³ stays in
+// range), and optionally log1p of each base feature. With logTarget the fit
+// is to log1p(PRP) and predictions are mapped back with expm1, which suits
+// the heavily skewed MMAX and PRP columns.
+
+struct ExpansionOptions
+{
+    int degree = 2;           // 1 to 3
+    bool logFeatures = false; // add log1p(x_j) terms
+    bool logTarget = false;   // regress log1p(PRP)
+};
+
+class FeatureExpansion
+{
+private:
+    struct Term
+    {
+        int inputs[3]; // indices into the scaled and log inputs, -1 = unused
+    };
+
+    ExpansionOptions mOptions;
+    std::vector<double> mScales; // root-mean-square of each base feature
+    std::vector<Term> mTerms;
+    std::vector<std::string> mNames;
+
+public:
+    // Scales come from the rows of data.
+    FeatureExpansion(const ExpansionOptions& options, const MachineData& data);
+
+    int nTerms() const {return static_cast<int>(mTerms.size());}
+    const std::vector<std::string>& names() const {return mNames;}
+    const ExpansionOptions& options() const {return mOptions;}
+
+    // Adds the expanded form of numRows row-major base rows to normal, which
+    // must have nTerms() features.
+    void accumulate(const double* X, const double* y, size_t numRows, NormalEquationsAccumulator& normal) const;
+
+    void expand(const double* x, double* terms) const; // one row, nTerms() values
+    double predict(const double* x, const Vector& weights) const;
+
+private:
+    FeatureExpansion() = delete;
+};
+
+// Expanded normal equations of every row of data, accumulated in parallel.
+NormalEquationsAccumulator accumulate_expanded(const FeatureExpansion& expansion, const MachineData& data,
+                                               unsigned numThreads = 0);
+
+// Solves (XᵀX + ridge·I) w = Xᵀy; a small ridge keeps the higher degree
+// systems, whose columns are strongly collinear, positive definite.
+Vector solve_expanded(NormalEquationsAccumulator& normal, double ridge);
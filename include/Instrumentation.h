@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// Hot-path instrumentation for Vector, Matrix and the linear systems, compiled
+// in only when TINYPROJECT_INSTRUMENT is defined (CMake option of the same
+// name); otherwise the macros below expand to nothing and their arguments are
+// never evaluated.
+//
+// Every public operation opens a scoped timer that counts the call, its
+// nominal FLOPs and bytes moved, and the heap allocations made while it is
+// the innermost open operation on its thread. FLOPs and bytes are the
+// operation's own work: what it does through other operations (CG through
+// Matrix * Vector, inverse through det) is counted there. Time is inclusive
+// and is only taken at the outermost level of a recursive operation (det), so
+// it is never counted twice. Counters live in thread-local blocks that only their own
+// thread writes; a snapshot sums every live block plus those of threads that
+// have exited.
+
+enum class InstrumentedOp
+{
+    VectorAssign, VectorUnary, VectorAdd, VectorSubtract, VectorDot, VectorScale,
+    MatrixAssign, MatrixUnary, MatrixAdd, MatrixSubtract, MatrixMultiply, MatrixScale, MatrixVector,
+    MatrixSwapRows, MatrixDet, MatrixMinor, MatrixInverse, MatrixTranspose, MatrixPseudoInverse,
+    GaussianSolve, SymmetryCheck, ConjugateGradientSolve, MoorePenroseSolve,
+    Untimed, // allocations made outside any timed operation (constructors called by user code)
+    Count
+};
+
+struct OpStats
+{
+    const char* name;
+    uint64_t calls;
+    uint64_t nanoseconds;
+    uint64_t flops;
+    uint64_t bytes;
+    uint64_t allocations;
+    uint64_t allocatedBytes;
+};
+
+struct InstrumentationSnapshot
+{
+    std::vector<OpStats> ops; // every operation with at least one call or allocation
+
+    void printTable(std::ostream& out) const;
+    void writeJson(std::ostream& out) const;
+};
+
+#ifdef TINYPROJECT_INSTRUMENT
+constexpr bool kInstrumentationEnabled = true;
+#else
+constexpr bool kInstrumentationEnabled = false;
+#endif
+
+// Totals over all threads since the last reset; empty when instrumentation is
+// compiled out.
+InstrumentationSnapshot instrumentation_snapshot();
+void instrumentation_reset();
+
+class ScopedOpTimer
+{
+private:
+    int mOp;
+    int mPrevious; // enclosing operation on this thread
+    bool mTimed;
+    int64_t mStart;
+
+public:
+    ScopedOpTimer(InstrumentedOp op, uint64_t flops, uint64_t bytes);
+    ~ScopedOpTimer();
+
+private:
+    ScopedOpTimer(const ScopedOpTimer&) = delete;
+    ScopedOpTimer& operator=(const ScopedOpTimer&) = delete;
+};
+
+// Heap allocations made by the instrumented classes, credited to the innermost
+// open operation on the calling thread.
+void instrumentation_add_allocations(uint64_t count, uint64_t bytes);
+
+#ifdef TINYPROJECT_INSTRUMENT
+#define TP_INSTRUMENT_OP(op, flops, bytes) \
+    ScopedOpTimer tpOpTimer(InstrumentedOp::op, static_cast<uint64_t>(flops), static_cast<uint64_t>(bytes))
+#define TP_INSTRUMENT_ALLOCATIONS(count, bytes) \
+    instrumentation_add_allocations(static_cast<uint64_t>(count), static_cast<uint64_t>(bytes))
+#else
+#define TP_INSTRUMENT_OP(op, flops, bytes) ((void)0)
+#define TP_INSTRUMENT_ALLOCATIONS(count, bytes) ((void)0)
+#endif
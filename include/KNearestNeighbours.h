@@ -0,0 +1,64 @@
+#pragma once
+
+#include "MachineData.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Instance-based regression (Kibler & Aha, cited in machine.names): the
+// prediction for x is the mean PRP of the k reference rows nearest to x in
+// standardised feature space (each predictor shifted to mean 0 and scaled to
+// unit standard deviation over the reference rows).
+//
+// The reference rows are stored column by column in KD-tree order, so both
+// a full scan and a leaf scan are the same batched squared-distance kernel
+// running across rows. The k best candidates are kept in a bounded max-heap.
+// The KD-tree splits at the median of the widest dimension down to leaves
+// of kLeafSize rows and is searched nearest child first, pruning subtrees
+// whose splitting plane is farther than the current k-th neighbour.
+
+class KNearestNeighbours
+{
+public:
+    enum class Search {BruteForce, KdTree};
+    static const size_t kLeafSize = 32;
+
+private:
+    struct Node
+    {
+        size_t begin, end; // rows [begin, end) in tree order
+        int dim;           // splitting dimension, -1 for a leaf
+        double split;
+        int left, right;
+    };
+
+    int mK;
+    size_t mNumRows;
+    std::vector<double> mMeans, mScales;
+    std::vector<double> mColumns; // standardised, feature-major: column j at j * mNumRows
+    std::vector<double> mTargets; // in tree order
+    std::vector<size_t> mOrder;   // tree position -> original row
+    std::vector<Node> mNodes;     // mNodes[0] is the root
+
+public:
+    KNearestNeighbours(const MachineData& reference, int k);
+
+    int k() const {return mK;}
+    size_t nRows() const {return mNumRows;}
+
+    // Original row indices and squared standardised distances of the k
+    // nearest reference rows to x, nearest first.
+    void neighbours(const double* x, size_t* indices, double* distances, Search search = Search::KdTree) const;
+
+    double predict(const double* x, Search search = Search::KdTree) const;
+
+    // Predictions for numRows row-major query rows, in parallel.
+    std::vector<double> predict(const double* X, size_t numRows, Search search = Search::KdTree,
+                                unsigned numThreads = 0) const;
+
+private:
+    int build(size_t begin, size_t end, std::vector<double>& points);
+    // (squared distance, tree position) of the k nearest rows, nearest first.
+    void nearest(const double* x, Search search, std::vector<std::pair<double, size_t>>& best) const;
+    KNearestNeighbours() = delete;
+};
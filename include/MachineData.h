@@ -0,0 +1,75 @@
+#pragma once
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Rows of the UCI Computer Hardware file (data/machine.data) that survive
+// parsing. features holds the six predictors MYCT, MMIN, MMAX, CACH, CHMIN
+// and CHMAX row by row (kNumFeatures values per row), targets holds PRP and
+// erp the published estimate ERP (NaN where it cannot be read). vendors holds
+// the code of each row's vendor (the first field), indexing vendorNames,
+// which lists the vendors in order of first appearance; erp, vendors and
+// vendorNames are empty for data that did not come from the parser.
+// Rows keep the order in which they appear in the file.
+
+struct MachineData
+{
+    static const int kNumFeatures = 6;
+    static const char* const kColumnNames[kNumFeatures + 2]; // predictors, then PRP and ERP
+
+    std::vector<double> features;
+    std::vector<double> targets;
+    std::vector<double> erp;
+    std::vector<int> vendors;
+    std::vector<std::string> vendorNames;
+
+    size_t rows() const {return targets.size();}
+    const double* row(size_t index) const {return features.data() + index * kNumFeatures;}
+};
+
+// Maps a machine.data style CSV file and splits it at line boundaries into one
+// chunk per thread (0 = hardware concurrency). The first line is treated as a
+// header and skipped; rows that do not have exactly 10 comma separated fields,
+// or whose numeric fields cannot be read, are dropped.
+class MachineDataReader
+{
+public:
+    // Receives the chunk index, the kNumFeatures predictors and PRP of a row.
+    typedef std::function<void(size_t chunk, const double* features, double prp)> RowFn;
+    // Also receives the vendor name, which points into the parsed text, and
+    // ERP (NaN if it cannot be read; the row is kept).
+    typedef std::function<void(size_t chunk, const char* vendor, size_t vendorLength,
+                               const double* features, double prp, double erp)> RecordFn;
+
+private:
+    MappedFile mFile;
+    std::vector<const char*> mBounds; // chunk k is [mBounds[k], mBounds[k+1])
+
+public:
+    MachineDataReader(const std::string& filename, unsigned numThreads = 0);
+
+    size_t numChunks() const {return mBounds.size() - 1;}
+
+    // Parses every chunk, concurrently, calling rowFn for each kept row. Rows
+    // of one chunk arrive in file order on a single thread.
+    void parse(const RowFn& rowFn) const;
+    void parse(const RecordFn& rowFn) const;
+    void parseChunk(size_t chunk, const RowFn& rowFn) const;
+    void parseChunk(size_t chunk, const RecordFn& rowFn) const;
+
+private:
+    MachineDataReader() = delete;
+    MachineDataReader(const MachineDataReader&) = delete;
+};
+
+// Parses the lines in [begin, end) with the rules above (no header skipping),
+// reporting rows as belonging to the given chunk.
+void parse_machine_lines(const char* begin, const char* end, size_t chunk, const MachineDataReader::RowFn& rowFn);
+void parse_machine_lines(const char* begin, const char* end, size_t chunk,
+                         const MachineDataReader::RecordFn& rowFn);
+
+// Reads the whole file into memory. The result is identical for any numThreads.
+MachineData read_machine_data(const std::string& filename, unsigned numThreads = 0);
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only view of a whole file mapped into memory (mmap on POSIX, a file
+// mapping on Windows). The mapping lives as long as the object; copying is
+// not allowed. An empty file gives data() == nullptr and size() == 0.
+
+class MappedFile
+{
+private:
+    const char* mData;
+    size_t mSize;
+#ifdef _WIN32
+    void* mFile;
+    void* mMapping;
+#else
+    int mFd;
+#endif
+
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    const char* data() const {return mData;}
+    size_t size() const {return mSize;}
+
+private:
+    MappedFile() = delete;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
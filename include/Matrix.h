@@ -63,8 +63,8 @@ public:
 
     // Utility
     void size() const;
-    int nRows() {return mNumRows;}
-    int nCols() {return mNumCols;}
+    int nRows() const {return mNumRows;}
+    int nCols() const {return mNumCols;}
     void print() const;
     void swapRows(int rIndex1, int rIndex2);
 
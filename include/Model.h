@@ -0,0 +1,72 @@
+#pragma once
+
+#include "MachineData.h"
+#include "Vector.h"
+#include <cassert>
+#include <string>
+#include <vector>
+
+// A trained linear model that can be written to disk and loaded by the
+// scoring engine. Predictions are
+//     ŷ = intercept + Σ weight_j (x_j - mean_j) / scale_j,
+// so models trained on standardised features carry their normalisation with
+// them; a plain least squares fit has mean 0 and scale 1.
+//
+// File layout (little-endian): magic "TPMODEL1", uint32 version, uint32
+// feature count, float64 intercept, then per feature a 16-byte name and the
+// float64 weight, mean and scale.
+
+class Model
+{
+private:
+    std::vector<std::string> mNames;
+    std::vector<double> mWeights;
+    std::vector<double> mMeans;
+    std::vector<double> mScales;
+    double mIntercept;
+    std::vector<double> mCoef; // weight_j / scale_j, for predictOne
+    double mBias;              // intercept with the means folded in
+
+public:
+    Model(const std::vector<std::string>& names, const Vector& weights);
+    Model(const std::vector<std::string>& names, const std::vector<double>& weights,
+          const std::vector<double>& means, const std::vector<double>& scales, double intercept);
+
+    static Model load(const std::string& filename);
+    void save(const std::string& filename) const;
+
+    int nFeatures() const {return static_cast<int>(mWeights.size());}
+    const std::vector<std::string>& names() const {return mNames;}
+    const std::vector<double>& weights() const {return mWeights;}
+    const std::vector<double>& means() const {return mMeans;}
+    const std::vector<double>& scales() const {return mScales;}
+    double intercept() const {return mIntercept;}
+
+    // Normalisation folded into the weights: ŷ = bias + Σ coef_j x_j.
+    std::vector<double> effectiveWeights() const;
+    double effectiveBias() const;
+
+    double predict(const double* features) const;
+
+    // Hot-path prediction for a model of exactly N features: a fully unrolled
+    // dot product against the folded coefficients, with no allocation, no
+    // branches and no exceptions. Check nFeatures() == N once at load time.
+    template <int N>
+    double predictOne(const double* features) const noexcept {
+        assert(nFeatures() == N);
+        const double* coef = mCoef.data();
+        double sum = mBias;
+        for (int j = 0; j < N; ++j) sum += coef[j] * features[j];
+        return sum;
+    }
+
+    // predictOne for the six machine.data predictors.
+    double predictOne(const double* features) const noexcept {
+        return predictOne<MachineData::kNumFeatures>(features);
+    }
+
+private:
+    void fold();
+
+    Model() = delete;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "DatasetCache.h"
+#include "Matrix.h"
+#include "Vector.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Streaming accumulator for the normal equations XᵀX w = Xᵀy of a least
+// squares fit. Rows are consumed one at a time and never stored beyond a small
+// batch, so memory is O(p²) whatever the number of rows. Pending rows are
+// folded into XᵀX with a rank-k update once kBatchRows of them have arrived.
+// Partial accumulators built on different threads can be merged.
+
+class NormalEquationsAccumulator
+{
+public:
+    static const int kBatchRows = 64;
+
+private:
+    int mNumFeatures;
+    size_t mNumRows;
+    std::vector<double> mXtX; // p x p, lower triangle kept up to date
+    std::vector<double> mXty;
+    double mYty;
+
+    std::vector<double> mBatch; // pending rows, row-major kBatchRows x p
+    std::vector<double> mBatchY;
+    int mBatchCount;
+
+public:
+    explicit NormalEquationsAccumulator(int numFeatures);
+
+    void addRow(const double* x, double y);
+    void addRows(const double* X, const double* y, size_t numRows); // X row-major
+    // A batch of count rows given feature by feature (feature j of every row
+    // at columns + j * count), for kernels that generate columns; it goes
+    // straight into the rank-k update without a copy.
+    void addColumns(const double* columns, const double* y, int count);
+    void merge(NormalEquationsAccumulator& other);
+    void subtract(NormalEquationsAccumulator& other); // removes rows other has seen
+    void flush();
+
+    int nFeatures() const {return mNumFeatures;}
+    size_t nRows() const {return mNumRows + mBatchCount;}
+
+    // Results; these flush any pending rows first.
+    Matrix gram();
+    Vector xty();
+    double yty();
+    const double* gramData(); // row-major p x p, both triangles filled
+    const double* xtyData();
+
+    Vector solve(); // Cholesky solve of XᵀX w = Xᵀy
+
+    // Σ (yᵢ - xᵢᵀw)² over the accumulated rows, = yᵀy - 2wᵀXᵀy + wᵀXᵀXw.
+    double sumSquaredError(const Vector& weights);
+
+private:
+    NormalEquationsAccumulator() = delete;
+};
+
+// Parses a machine.data file straight into normal equations, one accumulator
+// per parser chunk; the partial sums are merged in file order.
+NormalEquationsAccumulator accumulate_machine_data(const std::string& filename, unsigned numThreads = 0);
+
+// The same from a dataset cache: each worker pulls kColumnBlockRows rows of
+// the predictor and PRP columns at a time (packed columns decoded block by
+// block, never whole) and folds them in with one rank-k update per block.
+NormalEquationsAccumulator accumulate_dataset_cache(const DatasetCache& cache, unsigned numThreads = 0);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "MachineData.h"
+#include "NormalEquations.h"
+#include <cstddef>
+#include <vector>
+
+// Least squares on the numeric predictors plus a one-hot encoded category
+// (the vendor), y ≈ xᵀw + b_v for a row of category v. The indicator columns
+// are never stored: a row is its dense x and the code v. Because every row
+// has exactly one active indicator, the joint Gram matrix
+//     [ XᵀX  XᵀV ]
+//     [ VᵀX   D  ],   D = VᵀV = diag(rows per category),
+// has a diagonal category block, and XᵀV is just the per-category sums of x.
+// Accumulating costs the dense row update plus O(p) per row. The solve
+// eliminates the diagonal block with a Schur complement, a rank-m correction
+// of the p x p system:
+//     (XᵀX - XᵀV D⁻¹ VᵀX) w = Xᵀy - XᵀV D⁻¹ Vᵀy,   b = D⁻¹ (Vᵀy - VᵀX w),
+// so 30 vendors add O(p²m) to the solve instead of a (p+m)³ factorisation.
+
+struct OneHotFit
+{
+    std::vector<double> weights; // numeric predictors
+    std::vector<double> offsets; // b_v per category
+    double meanOffset;           // row-weighted mean of the offsets, for unseen categories
+
+    double predict(const double* x, int category) const;
+};
+
+class OneHotNormalEquations
+{
+private:
+    NormalEquationsAccumulator mDense; // XᵀX, Xᵀy
+    int mNumCategories;
+    std::vector<double> mSums;       // category-major m x p: VᵀX
+    std::vector<double> mCounts;     // diagonal of D
+    std::vector<double> mTargetSums; // Vᵀy
+
+public:
+    OneHotNormalEquations(int numFeatures, int numCategories);
+
+    void addRow(const double* x, int category, double y);
+    void merge(OneHotNormalEquations& other);
+
+    int nFeatures() const {return mDense.nFeatures();}
+    int nCategories() const {return mNumCategories;}
+    size_t nRows() const {return mDense.nRows();}
+
+    // ridge is added to D, shrinking rarely seen categories towards 0.
+    // Categories without rows get meanOffset.
+    OneHotFit solve(double ridge = 0.0);
+
+private:
+    OneHotNormalEquations() = delete;
+};
+
+// Numeric predictors and vendor codes of every row of data, in parallel.
+OneHotNormalEquations accumulate_vendor_equations(const MachineData& data, unsigned numThreads = 0);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Cholesky.h"
+#include "Vector.h"
+#include <cstddef>
+#include <vector>
+
+// Recursive least squares. Keeps the Cholesky factor of
+//     G = Σ λᵗ⁻ⁱ xᵢxᵢᵀ + δλᵗ I
+// and b = Σ λᵗ⁻ⁱ xᵢyᵢ, so a new row costs one O(p²) rank-1 update instead of
+// a refit. λ (forgetting, 0 < λ <= 1) down-weights old rows exponentially;
+// λ = 1 is ordinary least squares. δ (initialRidge) keeps G definite before p
+// rows have arrived. Rows can be removed again with a rank-1 downdate (only
+// meaningful without forgetting). Weights are re-solved, also in O(p²), the
+// first time they are needed after a change.
+
+class OnlineRegression
+{
+private:
+    int mNumFeatures;
+    double mForgetting;
+    Cholesky mChol;
+    std::vector<double> mXty;
+    std::vector<double> mWeights;
+    bool mSolved;
+    size_t mNumRows;
+
+public:
+    OnlineRegression(int numFeatures, double forgetting = 1.0, double initialRidge = 1e-6);
+
+    void addRow(const double* x, double y);
+    void removeRow(const double* x, double y);
+
+    double predict(const double* x);
+    Vector weights();
+
+    int nFeatures() const {return mNumFeatures;}
+    size_t nRows() const {return mNumRows;}
+
+private:
+    void solve();
+    OnlineRegression() = delete;
+};
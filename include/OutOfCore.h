@@ -0,0 +1,41 @@
+#pragma once
+
+#include "NormalEquations.h"
+#include "Vector.h"
+#include <cstddef>
+#include <string>
+
+// Out-of-core training for data files larger than RAM. The file is read in
+// fixed-size blocks through two buffers: while one block is parsed, the next
+// is read asynchronously into the other. Parsed rows go straight into normal
+// equations, so peak memory is the two blocks plus O(p²) statistics, i.e.
+// bounded by memoryBudget. Every holdoutEvery-th kept row is set aside in a
+// second accumulator, which gives the holdout RMSE without storing any row
+// (holdoutEvery = 5 reproduces the usual 80/20 split; 0 disables it).
+
+class OutOfCoreTrainer
+{
+private:
+    size_t mBlockBytes;
+    size_t mHoldoutEvery;
+    size_t mRowsSeen;
+    NormalEquationsAccumulator mTrain;
+    NormalEquationsAccumulator mHoldout;
+
+public:
+    explicit OutOfCoreTrainer(size_t memoryBudget = 64 << 20, size_t holdoutEvery = 5);
+
+    // Streams a machine.data style file (first line is a header).
+    void train(const std::string& filename);
+
+    Vector solve();
+    double holdoutRmse(const Vector& weights);
+
+    size_t trainRows() const {return mTrain.nRows();}
+    size_t holdoutRows() const {return mHoldout.nRows();}
+    size_t blockBytes() const {return mBlockBytes;}
+
+private:
+    void addRow(const double* features, double prp);
+    OutOfCoreTrainer(const OutOfCoreTrainer&) = delete;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Splits [0, count) into one contiguous range per worker and runs
+// fn(begin, end, worker) on up to numThreads threads (0 = hardware
+// concurrency). The calling thread runs worker 0. Exceptions thrown by any
+// worker are rethrown, lowest worker first.
+void parallel_ranges(size_t count, unsigned numThreads,
+                     const std::function<void(size_t begin, size_t end, unsigned worker)>& fn);
+
+// Runs fn(i) for every i in [0, count) using parallel_ranges.
+void parallel_for(size_t count, unsigned numThreads, const std::function<void(size_t index)>& fn);
+
+// Number of workers parallel_ranges will use for count items.
+unsigned worker_count(size_t count, unsigned numThreads);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+// Least squares regression on a design matrix X (one row per sample) and
+// targets Y, as used by the CPU performance predictor in tinyProject.cpp.
+
+// Weights w minimising |Xw - Y|², from the normal equations.
+Vector solve_linear_regression(Matrix& X, Vector& Y);
+
+// Several targets at once (one column of Y each, e.g. PRP and ERP): XᵀX is
+// factorised once and every column of the p x t weight matrix W comes from
+// the same multi-right-hand-side solve. XᵀX and XᵀY are accumulated in
+// batches of rows, a rank-k update and one XᵀY GEMM per batch. Y must be
+// finite: a single NaN target turns its whole column of W into NaN, so rows
+// with a missing target have to be dropped before the call.
+Matrix solve_linear_regression(Matrix& X, Matrix& Y);
+
+// Predictions Xw.
+Vector predict(Matrix& X, Vector& weights);
+Matrix predict(Matrix& X, Matrix& weights); // one column per target
+
+// Root mean square error between predicted and actual values.
+double compute_rmse(const Vector& predicted, const Vector& actual);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "NormalEquations.h"
+#include "Vector.h"
+#include <cstddef>
+#include <vector>
+
+// Ridge regression over a whole path of penalties from one decomposition.
+// The columns are first scaled to unit root-mean-square so that one λ means
+// the same for MYCT and for MMAX. The scaled Gram matrix is diagonalised once,
+// G = V diag(d) Vᵀ, and with c = VᵀXᵀy every point of the path is
+//     w(λ) = V diag(1 / (d + λ)) c,
+// O(p²) per λ. The validation error of each w(λ) comes from the validation
+// rows' sufficient statistics, also O(p²). Points are evaluated in parallel.
+
+struct RidgePath
+{
+    std::vector<double> lambdas;
+    std::vector<Vector> weights; // in the original feature scale
+    std::vector<double> validationRmse;
+    size_t best;                 // index of the lowest validation RMSE
+};
+
+// lambdas must be non-empty and non-negative.
+RidgePath ridge_path(NormalEquationsAccumulator& train, NormalEquationsAccumulator& validation,
+                     const std::vector<double>& lambdas, unsigned numThreads = 0);
+
+// count penalties spaced evenly in log scale from lo to hi.
+std::vector<double> log_spaced_lambdas(double lo, double hi, int count);
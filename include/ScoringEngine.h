@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Model.h"
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Batch scoring of feature files with a trained Model. Input is either raw
+// little-endian float64 rows (nFeatures values per row) or CSV text with
+// nFeatures comma separated values per line; a blank CSV line or one with the
+// wrong number of values scores as NaN so outputs stay aligned with inputs.
+// Predictions are written as float64 (binary) or one number per line (text).
+//
+// Files are memory-mapped and consumed in slices of kSliceBytes; stdin is read
+// in slices of the same size. Each slice is split across threads, every
+// thread scores its rows with a vectorised GEMV into its own buffer, and the
+// buffers are written out in input order.
+
+enum class FeatureFormat { Binary, Csv };
+
+class ScoringEngine
+{
+public:
+    static const size_t kSliceBytes = 16 << 20;
+
+private:
+    int mNumFeatures;
+    std::vector<double> mCoef;
+    double mBias;
+    unsigned mNumThreads;
+
+public:
+    explicit ScoringEngine(const Model& model, unsigned numThreads = 0);
+
+    // out[i] = prediction for row i of the row-major X.
+    void scoreRows(const double* X, size_t numRows, double* out) const;
+
+    // Return the number of rows scored.
+    size_t scoreFile(const std::string& filename, FeatureFormat format, std::ostream& out, bool textOutput) const;
+    size_t scoreStream(std::istream& in, FeatureFormat format, std::ostream& out, bool textOutput) const;
+
+private:
+    size_t scoreSlice(const char* begin, const char* end, FeatureFormat format,
+                      std::ostream& out, bool textOutput) const;
+    void scoreCsv(const char* begin, const char* end, std::vector<double>& predictions) const;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Mini-batch stochastic gradient trainer for the same model as
+// solve_linear_regression, for data sets where even one exact pass is too
+// expensive and an early-stopped approximate fit is enough.
+//
+// Features and target are scaled to unit root-mean-square internally, so one
+// learning rate suits every column; the weights returned are in the original
+// scale. Worker threads each own a shard of the rows and update the shared
+// weights Hogwild style: reads and writes are relaxed atomics without locks,
+// and an update racing with another may be partly lost. Every worker keeps
+// its own momentum / Adam moments. The gradient of a batch is computed with
+// the batch laid across the inner loop so it vectorises. After every epoch
+// the validation RMSE (compute_rmse) decides on early stopping, and the best
+// weights seen are kept.
+
+enum class SgdOptimizer { Sgd, Momentum, Adam };
+
+struct SgdOptions
+{
+    SgdOptimizer optimizer = SgdOptimizer::Adam;
+    double learningRate = 0.01;
+    double momentum = 0.9;      // Momentum
+    double beta1 = 0.9;         // Adam
+    double beta2 = 0.999;       // Adam
+    double epsilon = 1e-8;      // Adam
+    size_t batchSize = 32;
+    int maxEpochs = 500;
+    int patience = 20;          // epochs without improvement before stopping
+    unsigned numThreads = 0;    // 0 = hardware concurrency
+    uint64_t seed = 42;
+};
+
+struct SgdResult
+{
+    Vector weights;
+    int epochs;
+    double validationRmse;
+    std::vector<double> history; // validation RMSE after every epoch
+};
+
+class SgdTrainer
+{
+private:
+    SgdOptions mOptions;
+
+public:
+    explicit SgdTrainer(const SgdOptions& options = SgdOptions());
+
+    // Rows of X and Y held in memory; shards are reshuffled every epoch.
+    SgdResult train(Matrix& X, Vector& Y, Matrix& X_val, Vector& Y_val);
+
+    // Streams a machine.data style file once per epoch, one parser chunk per
+    // worker, without keeping the rows.
+    SgdResult trainFile(const std::string& filename, Matrix& X_val, Vector& Y_val);
+};
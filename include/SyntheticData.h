@@ -0,0 +1,48 @@
+#pragma once
+
+#include "MachineData.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Seeded synthetic machine.data rows at any scale, for benchmarks. Rows follow
+// the real file's marginals: the predictors are log-normal around one shared
+// "machine size" factor (cycle time falls as memory, cache and channels grow),
+// clamped to the ranges seen in machine.data, with the observed share of
+// machines without cache or channels. ERP is linear in the predictors and PRP
+// is ERP times log-normal noise; vendors are drawn with their real frequency.
+//
+// Row i depends only on (seed, i): its draws are CounterRng(seed) outputs
+// 16i..16i+15, so any block of rows can be generated on any thread and the
+// output is identical for every thread count.
+
+struct SyntheticRow
+{
+    int vendor; // index into SyntheticMachineData::vendorNames()
+    double features[MachineData::kNumFeatures];
+    double prp;
+    double erp;
+};
+
+class SyntheticMachineData
+{
+private:
+    uint64_t mSeed;
+
+public:
+    explicit SyntheticMachineData(uint64_t seed = 42): mSeed(seed) {}
+
+    void row(size_t index, SyntheticRow& out) const;
+    static const std::vector<std::string>& vendorNames();
+};
+
+// Writes a header line and numRows rows as machine.data CSV (vendor, model
+// name, six predictors, PRP, ERP). Workers format blocks of rows into their
+// own buffers and write them at their file offsets in parallel, one round of
+// blocks at a time.
+void write_synthetic_csv(const std::string& path, size_t numRows, uint64_t seed = 42, unsigned numThreads = 0);
+
+// The same rows as a dataset cache (see DatasetCache.h) with the columns of a
+// cached machine.data: predictors, PRP, ERP and VENDOR.
+void write_synthetic_cache(const std::string& path, size_t numRows, uint64_t seed = 42, unsigned numThreads = 0);
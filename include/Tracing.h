@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Timeline tracing of the pipeline stages (parse, Gram build, solve, predict,
+// RMSE) and the solver phases, compiled in only when TINYPROJECT_TRACE is
+// defined (CMake option of the same name); otherwise TP_TRACE_SCOPE expands to
+// nothing.
+//
+// A scope records one event holding its begin and end timestamps, so it is
+// written as a Chrome "complete" (ph "X") event and an overwritten begin can
+// never leave an unmatched end. Every thread appends to its own fixed-size
+// ring buffer without locks; when the ring is full the oldest events are
+// overwritten and counted as dropped. A collector copies each ring and keeps
+// only the slots the owner could not have reused while it was reading.
+// Events of threads that have exited are kept until the next reset.
+//
+// The output loads in chrome://tracing and https://ui.perfetto.dev.
+
+#ifdef TINYPROJECT_TRACE
+constexpr bool kTracingEnabled = true;
+#else
+constexpr bool kTracingEnabled = false;
+#endif
+
+// Events each thread keeps before overwriting its oldest.
+const size_t kTraceRingEvents = size_t(1) << 16;
+
+// Names must be string literals (or otherwise outlive the trace): only the
+// pointer is stored.
+class ScopedTraceEvent
+{
+private:
+    const char* mName;
+    int64_t mBegin;
+
+public:
+    explicit ScopedTraceEvent(const char* name);
+    ~ScopedTraceEvent();
+
+private:
+    ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+    ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+};
+
+// Every event recorded since the last reset, as {"traceEvents": [...]} with a
+// thread_name entry per thread. Returns the number of events written.
+size_t write_chrome_trace(std::ostream& out);
+size_t write_chrome_trace(const std::string& path);
+// Events lost to full rings since the last reset.
+uint64_t trace_dropped_events();
+// Forgets every event recorded so far; threads may keep recording.
+void trace_reset();
+
+#ifdef TINYPROJECT_TRACE
+#define TP_TRACE_CONCAT_(a, b) a##b
+#define TP_TRACE_CONCAT(a, b) TP_TRACE_CONCAT_(a, b)
+#define TP_TRACE_SCOPE(name) ScopedTraceEvent TP_TRACE_CONCAT(tpTraceEvent, __LINE__)(name)
+#else
+#define TP_TRACE_SCOPE(name) ((void)0)
+#endif
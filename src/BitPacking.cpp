@@ -0,0 +1,102 @@
+#include "../include/BitPacking.h"
+#include <cmath>
+
+using namespace std;
+
+bool bitpack_plan(const double* values, size_t count, int64_t& reference, int& bitWidth) {
+    const double limit = 9007199254740992.0; // 2^53, beyond it doubles skip integers
+    double lo = 0.0, hi = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double v = values[i];
+        if (!(fabs(v) < limit) || v != floor(v))
+            return false;
+        if (i == 0 || v < lo) lo = v;
+        if (i == 0 || v > hi) hi = v;
+    }
+
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(hi) - static_cast<int64_t>(lo));
+    if (range > 0xFFFFFFFFULL)
+        return false;
+
+    reference = static_cast<int64_t>(lo);
+    bitWidth = 0;
+    while (bitWidth < 32 && (range >> bitWidth) != 0) ++bitWidth;
+    return true;
+}
+
+size_t bitpack_blocks(size_t count) {
+    return (count + kBitPackBlock - 1) / kBitPackBlock;
+}
+
+size_t bitpack_words(size_t count, int bitWidth) {
+    return bitpack_blocks(count) * bitWidth * kBitPackLanes;
+}
+
+void bitpack_encode(const double* values, size_t count, int64_t reference, int bitWidth, uint32_t* words) {
+    size_t numWords = bitpack_words(count, bitWidth);
+    for (size_t w = 0; w < numWords; ++w) words[w] = 0;
+    if (bitWidth == 0) return;
+
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t v = static_cast<uint64_t>(static_cast<int64_t>(values[i]) - reference);
+        size_t block = i / kBitPackBlock;
+        size_t lane = i % kBitPackLanes;
+        size_t depth = (i % kBitPackBlock) / kBitPackLanes;
+
+        uint32_t* base = words + block * bitWidth * kBitPackLanes + lane;
+        size_t bit = depth * bitWidth;
+        size_t word = bit / 32, shift = bit % 32;
+        base[word * kBitPackLanes] |= static_cast<uint32_t>(v << shift);
+        if (shift + bitWidth > 32)
+            base[(word + 1) * kBitPackLanes] |= static_cast<uint32_t>(v >> (32 - shift));
+    }
+}
+
+void bitpack_decode(const uint32_t* words, int64_t reference, int bitWidth,
+                    size_t firstBlock, size_t numBlocks, double* out) {
+    const double ref = static_cast<double>(reference);
+    if (bitWidth == 0) {
+        for (size_t i = 0; i < numBlocks * kBitPackBlock; ++i) out[i] = ref;
+        return;
+    }
+
+    const uint32_t mask = bitWidth == 32 ? 0xFFFFFFFFu : (1u << bitWidth) - 1;
+    for (size_t b = 0; b < numBlocks; ++b) {
+        const uint32_t* block = words + (firstBlock + b) * bitWidth * kBitPackLanes;
+        double* dst = out + b * kBitPackBlock;
+
+        for (size_t depth = 0; depth < 32; ++depth) {
+            size_t bit = depth * bitWidth;
+            const uint32_t* lo = block + (bit / 32) * kBitPackLanes;
+            unsigned shift = bit % 32;
+            double* row = dst + depth * kBitPackLanes;
+
+            // Same shift for every lane: these loops vectorise.
+            if (shift + bitWidth > 32) {
+                const uint32_t* hi = lo + kBitPackLanes;
+                for (size_t lane = 0; lane < kBitPackLanes; ++lane) {
+                    uint32_t v = ((lo[lane] >> shift) | (hi[lane] << (32 - shift))) & mask;
+                    row[lane] = ref + static_cast<double>(v);
+                }
+            } else {
+                for (size_t lane = 0; lane < kBitPackLanes; ++lane) {
+                    uint32_t v = (lo[lane] >> shift) & mask;
+                    row[lane] = ref + static_cast<double>(v);
+                }
+            }
+        }
+    }
+}
+
+double bitpack_get(const uint32_t* words, int64_t reference, int bitWidth, size_t index) {
+    const double ref = static_cast<double>(reference);
+    if (bitWidth == 0) return ref;
+
+    const uint32_t* base = words + index / kBitPackBlock * bitWidth * kBitPackLanes + index % kBitPackLanes;
+    size_t bit = (index % kBitPackBlock) / kBitPackLanes * bitWidth;
+    const uint32_t* lo = base + (bit / 32) * kBitPackLanes;
+    unsigned shift = bit % 32;
+    uint64_t v = lo[0] >> shift;
+    if (shift + bitWidth > 32) v |= static_cast<uint64_t>(lo[kBitPackLanes]) << (32 - shift);
+    return ref + static_cast<double>(v & ((uint64_t(1) << bitWidth) - 1));
+}
@@ -0,0 +1,100 @@
+#include "../include/Bootstrap.h"
+#include "../include/NormalEquations.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+// Solves the accumulated normal equations into weights. Returns false if XᵀX
+// is not positive definite.
+bool solve_normal(NormalEquationsAccumulator& normal, double* weights) {
+    try {
+        Vector w = normal.solve();
+        for (int j = 0; j < w.size(); ++j) weights[j] = w[j];
+    } catch (const runtime_error&) {
+        return false;
+    }
+    return true;
+}
+
+}
+
+double sorted_quantile(const vector<double>& sorted, double q) {
+    if (sorted.empty())
+        throw runtime_error("Quantile of an empty sample.");
+    double h = q * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(floor(h));
+    if (lo + 1 >= sorted.size()) return sorted.back();
+    return sorted[lo] + (h - lo) * (sorted[lo + 1] - sorted[lo]);
+}
+
+BootstrapResult bootstrap_weights(const MachineData& data, int numReplicates, double confidence,
+                                  uint64_t seed, unsigned numThreads) {
+    const int p = MachineData::kNumFeatures;
+    const size_t n = data.rows();
+    if (numReplicates <= 0)
+        throw runtime_error("Number of bootstrap replicates must be positive.");
+    if (!(confidence > 0.0 && confidence < 1.0))
+        throw runtime_error("Confidence level must be between 0 and 1.");
+    if (n < static_cast<size_t>(p))
+        throw runtime_error("Not enough rows to bootstrap the regression.");
+
+    BootstrapResult result;
+    result.estimate.assign(p, 0.0);
+    NormalEquationsAccumulator original(p);
+    original.addRows(data.row(0), data.targets.data(), n);
+    if (!solve_normal(original, result.estimate.data()))
+        throw runtime_error("XᵀX of the original rows is singular.");
+
+    // Replicates, each accumulated from its own draws.
+    vector<double> all(static_cast<size_t>(numReplicates) * p);
+    vector<char> ok(numReplicates, 0);
+    parallel_for(numReplicates, numThreads, [&](size_t r) {
+        seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32), static_cast<uint32_t>(r)};
+        mt19937_64 rng(seq);
+        uniform_int_distribution<size_t> pick(0, n - 1);
+
+        NormalEquationsAccumulator normal(p);
+        for (size_t k = 0; k < n; ++k) {
+            size_t i = pick(rng);
+            normal.addRow(data.row(i), data.targets[i]);
+        }
+        ok[r] = solve_normal(normal, &all[r * p]);
+    });
+
+    for (int r = 0; r < numReplicates; ++r) {
+        if (ok[r]) result.weights.insert(result.weights.end(), &all[r * p], &all[r * p] + p);
+    }
+    result.replicates = result.weights.size() / p;
+    result.failed = numReplicates - result.replicates;
+    if (result.replicates < 2)
+        throw runtime_error("Too few bootstrap replicates could be solved.");
+
+    // Percentile intervals and standard errors, weight by weight.
+    double tail = (1.0 - confidence) / 2.0;
+    result.lower.resize(p);
+    result.upper.resize(p);
+    result.standardError.resize(p);
+    vector<double> column(result.replicates);
+    for (int j = 0; j < p; ++j) {
+        double mean = 0.0;
+        for (size_t r = 0; r < result.replicates; ++r) {
+            column[r] = result.weights[r * p + j];
+            mean += column[r];
+        }
+        mean /= result.replicates;
+        double ss = 0.0;
+        for (double w : column) ss += (w - mean) * (w - mean);
+        result.standardError[j] = sqrt(ss / (result.replicates - 1));
+
+        sort(column.begin(), column.end());
+        result.lower[j] = sorted_quantile(column, tail);
+        result.upper[j] = sorted_quantile(column, 1.0 - tail);
+    }
+    return result;
+}
@@ -0,0 +1,164 @@
+#include "../include/Cholesky.h"
+#include "../include/Tracing.h"
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+// Constructors
+Cholesky::Cholesky(const Matrix& A): mSize(A.nRows()), mL(static_cast<size_t>(mSize) * mSize), mWork(mSize) {
+    if (A.nRows() != A.nCols())
+        throw runtime_error("Matrix must be square.");
+    for (int i = 0; i < mSize; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            mL[i * mSize + j] = A[i][j];
+        }
+    }
+    factorise();
+}
+
+Cholesky::Cholesky(const double* A, int size): mSize(size), mL(static_cast<size_t>(size) * size), mWork(size) {
+    for (int i = 0; i < mSize; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            mL[i * mSize + j] = A[i * mSize + j];
+        }
+    }
+    factorise();
+}
+
+// Row-oriented Cholesky–Banachiewicz: row i of L only needs rows 0..i.
+void Cholesky::factorise() {
+    TP_TRACE_SCOPE("cholesky factorise");
+    for (int i = 0; i < mSize; ++i) {
+        double* Li = &mL[i * mSize];
+        for (int j = 0; j <= i; ++j) {
+            const double* Lj = &mL[j * mSize];
+            double sum = Li[j];
+            for (int k = 0; k < j; ++k) {
+                sum -= Li[k] * Lj[k];
+            }
+            if (i == j) {
+                if (!(sum > 0.0))
+                    throw runtime_error("Matrix is not positive definite.");
+                Li[i] = sqrt(sum);
+            } else {
+                Li[j] = sum / Lj[j];
+            }
+        }
+        for (int j = i + 1; j < mSize; ++j) {
+            Li[j] = 0.0;
+        }
+    }
+}
+
+// Solvers
+Vector Cholesky::Solve(const Vector& b) const {
+    if (b.size() != mSize)
+        throw runtime_error("Matrix and vector sizes are incompatible.");
+    vector<double> x(mSize);
+    for (int i = 0; i < mSize; ++i) x[i] = b[i];
+    solveInPlace(x.data());
+
+    Vector result(mSize);
+    for (int i = 0; i < mSize; ++i) result[i] = x[i];
+    return result;
+}
+
+void Cholesky::solveInPlace(double* x) const {
+    TP_TRACE_SCOPE("cholesky solve");
+    forwardInPlace(x);
+    backwardInPlace(x);
+}
+
+void Cholesky::solveInPlace(double* B, int numRhs) const {
+    TP_TRACE_SCOPE("cholesky solve");
+    const int m = numRhs;
+    for (int i = 0; i < mSize; ++i) {
+        const double* Li = &mL[i * mSize];
+        double* Bi = &B[i * m];
+        for (int k = 0; k < i; ++k) {
+            const double l = Li[k];
+            const double* Bk = &B[k * m];
+            for (int r = 0; r < m; ++r) Bi[r] -= l * Bk[r];
+        }
+        const double inv = 1.0 / Li[i];
+        for (int r = 0; r < m; ++r) Bi[r] *= inv;
+    }
+    for (int i = mSize - 1; i >= 0; --i) {
+        double* Bi = &B[i * m];
+        for (int k = i + 1; k < mSize; ++k) {
+            const double l = mL[k * mSize + i];
+            const double* Bk = &B[k * m];
+            for (int r = 0; r < m; ++r) Bi[r] -= l * Bk[r];
+        }
+        const double inv = 1.0 / mL[i * mSize + i];
+        for (int r = 0; r < m; ++r) Bi[r] *= inv;
+    }
+}
+
+void Cholesky::forwardInPlace(double* x) const {
+    for (int i = 0; i < mSize; ++i) {
+        const double* Li = &mL[i * mSize];
+        double sum = x[i];
+        for (int k = 0; k < i; ++k) {
+            sum -= Li[k] * x[k];
+        }
+        x[i] = sum / Li[i];
+    }
+}
+
+void Cholesky::backwardInPlace(double* x) const {
+    for (int i = mSize - 1; i >= 0; --i) {
+        double sum = x[i];
+        for (int k = i + 1; k < mSize; ++k) {
+            sum -= mL[k * mSize + i] * x[k];
+        }
+        x[i] = sum / mL[i * mSize + i];
+    }
+}
+
+// Rank-one modifications
+// Classic rotation scheme: column k of L absorbs x[k] and x is rotated
+// against it for the remaining rows; a downdate uses hyperbolic rotations.
+// Runs in place on a preallocated work vector, so it never allocates.
+void Cholesky::rankOne(const double* x, double sign) {
+    double* v = mWork.data();
+    for (int i = 0; i < mSize; ++i) v[i] = x[i];
+
+    for (int k = 0; k < mSize; ++k) {
+        double Lkk = mL[k * mSize + k];
+        double r = sqrt(Lkk * Lkk + sign * v[k] * v[k]);
+        double c = r / Lkk;
+        double s = v[k] / Lkk;
+        mL[k * mSize + k] = r;
+        for (int i = k + 1; i < mSize; ++i) {
+            double& Lik = mL[i * mSize + k];
+            Lik = (Lik + sign * s * v[i]) / c;
+            v[i] = c * v[i] - s * Lik;
+        }
+    }
+}
+
+void Cholesky::update(const double* x) {
+    rankOne(x, 1.0);
+}
+
+// A - x xᵀ stays positive definite exactly when |L⁻¹x| < 1; checking first
+// leaves the factor untouched on failure.
+void Cholesky::downdate(const double* x) {
+    for (int i = 0; i < mSize; ++i) mWork[i] = x[i];
+    forwardInPlace(mWork.data());
+    double norm2 = 0.0;
+    for (int i = 0; i < mSize; ++i) norm2 += mWork[i] * mWork[i];
+    if (!(norm2 < 1.0 - 1e-12))
+        throw runtime_error("Downdate would make the matrix indefinite.");
+
+    rankOne(x, -1.0);
+}
+
+void Cholesky::scale(double factor) {
+    if (!(factor > 0.0))
+        throw runtime_error("Scale factor must be positive.");
+    double root = sqrt(factor);
+    for (double& value : mL) value *= root;
+}
@@ -0,0 +1,168 @@
+#include "../include/CrossValidation.h"
+#include "../include/Cholesky.h"
+#include "../include/DatasetSplit.h"
+#include "../include/NormalEquations.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+vector<int> assign_folds(size_t numRows, int numFolds, uint64_t seed) {
+    if (numFolds < 2 || static_cast<size_t>(numFolds) > numRows)
+        throw runtime_error("Number of folds must be between 2 and the number of rows.");
+
+    DatasetSplit split(numRows, 1.0, seed);
+    vector<int> fold(numRows);
+    for (int f = 0; f < numFolds; ++f) {
+        for (uint32_t i : split.fold(f, numFolds)) fold[i] = f;
+    }
+    return fold;
+}
+
+CrossValidationResult k_fold_cross_validation(const MachineData& data, int numFolds, uint64_t seed,
+                                              unsigned numThreads) {
+    vector<int> fold = assign_folds(data.rows(), numFolds, seed);
+
+    // Pass 1: per-fold partial normal equations. Each worker scans a range
+    // of rows into its own set of fold accumulators; these are then merged.
+    const NormalEquationsAccumulator empty(MachineData::kNumFeatures);
+    unsigned workers = worker_count(data.rows(), numThreads);
+    vector<vector<NormalEquationsAccumulator>> local(workers, vector<NormalEquationsAccumulator>(numFolds, empty));
+    parallel_ranges(data.rows(), workers, [&](size_t begin, size_t end, unsigned w) {
+        for (size_t i = begin; i < end; ++i) {
+            local[w][fold[i]].addRow(data.row(i), data.targets[i]);
+        }
+    });
+
+    vector<NormalEquationsAccumulator> parts(numFolds, empty);
+    NormalEquationsAccumulator total = empty;
+    for (int f = 0; f < numFolds; ++f) {
+        for (unsigned w = 0; w < workers; ++w) parts[f].merge(local[w][f]);
+        total.merge(parts[f]);
+    }
+
+    // Pass 2: O(p²) per fold, no data access.
+    CrossValidationResult result;
+    result.foldRmse.assign(numFolds, 0.0);
+    result.foldRows.assign(numFolds, 0);
+    vector<double> foldSse(numFolds, 0.0);
+    parallel_for(numFolds, numThreads, [&](size_t f) {
+        NormalEquationsAccumulator train = total;
+        train.subtract(parts[f]);
+        Vector weights = train.solve();
+
+        NormalEquationsAccumulator heldOut = parts[f];
+        foldSse[f] = heldOut.sumSquaredError(weights);
+        result.foldRows[f] = heldOut.nRows();
+        result.foldRmse[f] = sqrt(foldSse[f] / heldOut.nRows());
+    });
+
+    double sse = accumulate(foldSse.begin(), foldSse.end(), 0.0);
+    result.rmse = sqrt(sse / data.rows());
+    result.meanRmse = accumulate(result.foldRmse.begin(), result.foldRmse.end(), 0.0) / numFolds;
+    return result;
+}
+
+namespace {
+
+const size_t kLeverageBatch = 8;
+// Below this 1 - hᵢᵢ the closed form divides by (nearly) zero; such rows are
+// refitted instead.
+const double kLeverageTolerance = 1e-8;
+
+// Residuals and leverages of rows [begin, begin + count), count <= kLeverageBatch.
+// Rows are transposed into z (feature-major), then L z = x is solved for all of
+// them at once; every inner loop runs across the batch.
+void leverage_batch(const MachineData& data, size_t begin, size_t count, const Cholesky& chol,
+                    const double* weights, double* residuals, double* leverage) {
+    const int p = MachineData::kNumFeatures;
+    const size_t B = kLeverageBatch;
+    const double* L = chol.factor();
+
+    double z[MachineData::kNumFeatures][kLeverageBatch] = {};
+    double fit[kLeverageBatch] = {};
+    for (size_t r = 0; r < count; ++r) {
+        for (int j = 0; j < p; ++j) z[j][r] = data.row(begin + r)[j];
+    }
+    for (int j = 0; j < p; ++j) {
+        for (size_t r = 0; r < B; ++r) fit[r] += z[j][r] * weights[j];
+    }
+
+    double h[kLeverageBatch] = {};
+    for (int i = 0; i < p; ++i) {
+        for (int k = 0; k < i; ++k) {
+            const double Lik = L[i * p + k];
+            for (size_t r = 0; r < B; ++r) z[i][r] -= Lik * z[k][r];
+        }
+        const double inv = 1.0 / L[i * p + i];
+        for (size_t r = 0; r < B; ++r) {
+            z[i][r] *= inv;
+            h[r] += z[i][r] * z[i][r];
+        }
+    }
+
+    for (size_t r = 0; r < count; ++r) {
+        leverage[r] = h[r];
+        residuals[r] = 1.0 - h[r] > kLeverageTolerance ? (data.targets[begin + r] - fit[r]) / (1.0 - h[r]) : 0.0;
+    }
+}
+
+// Residual of row i under the fit without it, by downdating the factor of
+// XᵀX with xᵢ and solving against Xᵀy - yᵢxᵢ. The downdate refuses a row that
+// alone determines a direction of the fit (hᵢᵢ = 1).
+double refit_residual(const MachineData& data, size_t i, const Cholesky& chol, const Vector& xty) {
+    const int p = MachineData::kNumFeatures;
+    const double* x = data.row(i);
+    Cholesky without = chol;
+    try {
+        without.downdate(x);
+    } catch (const runtime_error&) {
+        throw runtime_error("Row " + to_string(i) + " alone determines a direction of the fit; "
+                            "its leave-one-out prediction is undefined.");
+    }
+    double w[MachineData::kNumFeatures];
+    for (int j = 0; j < p; ++j) w[j] = xty[j] - data.targets[i] * x[j];
+    without.solveInPlace(w);
+
+    double fit = 0.0;
+    for (int j = 0; j < p; ++j) fit += x[j] * w[j];
+    return data.targets[i] - fit;
+}
+
+}
+
+LeaveOneOutResult leave_one_out(const MachineData& data, unsigned numThreads) {
+    NormalEquationsAccumulator normal(MachineData::kNumFeatures);
+    normal.addRows(data.features.data(), data.targets.data(), data.rows());
+    Cholesky chol(normal.gramData(), MachineData::kNumFeatures);
+
+    Vector w = chol.Solve(normal.xty());
+    double weights[MachineData::kNumFeatures];
+    for (int j = 0; j < MachineData::kNumFeatures; ++j) weights[j] = w[j];
+
+    LeaveOneOutResult result;
+    result.residuals.resize(data.rows());
+    result.leverage.resize(data.rows());
+
+    size_t numBatches = (data.rows() + kLeverageBatch - 1) / kLeverageBatch;
+    parallel_for(numBatches, numThreads, [&](size_t b) {
+        size_t begin = b * kLeverageBatch;
+        size_t count = min(kLeverageBatch, data.rows() - begin);
+        leverage_batch(data, begin, count, chol, weights,
+                       &result.residuals[begin], &result.leverage[begin]);
+    });
+
+    Vector xty = normal.xty();
+    for (size_t i = 0; i < data.rows(); ++i) {
+        if (1.0 - result.leverage[i] <= kLeverageTolerance) result.residuals[i] = refit_residual(data, i, chol, xty);
+    }
+
+    double press = 0.0;
+    for (double e : result.residuals) press += e * e;
+    result.rmse = sqrt(press / data.rows());
+    return result;
+}
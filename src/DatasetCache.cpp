@@ -0,0 +1,400 @@
+#include "../include/DatasetCache.h"
+#include "../include/BitPacking.h"
+#include "../include/Parallel.h"
+#include "../include/Tracing.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const char kMagic[8] = {'T', 'P', 'C', 'A', 'C', 'H', 'E', '1'};
+const uint32_t kVersion = 4;
+const size_t kAlign = 64;
+const size_t kHashWindow = 1 << 16;
+const size_t kWriteBlockRows = 1 << 16; // rows per block of a streamed cache
+
+const uint32_t kEncodingFloat64 = 0;
+const uint32_t kEncodingPacked = 1; // frame of reference (= min) + bit packing
+const uint32_t kFlagHasRange = 1;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t numColumns;
+    uint64_t numRows;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceHash;
+    uint64_t dictionaryOffset; // vendor names, '\n' separated; 0 if none
+    uint64_t dictionaryBytes;
+};
+
+struct ColumnDescriptor
+{
+    char name[16];
+    uint64_t offset;
+    uint64_t bytes;
+    uint32_t encoding;
+    uint32_t flags;
+    double min;
+    double max;
+    uint32_t bitWidth;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 64, "cache header must be 64 bytes");
+static_assert(sizeof(ColumnDescriptor) == 64, "column descriptor must be 64 bytes");
+
+size_t align_up(size_t offset) {
+    return (offset + kAlign - 1) / kAlign * kAlign;
+}
+
+// [offset, offset + bytes) lies inside a file of fileSize bytes; written so
+// that a corrupt offset or size cannot wrap around.
+bool in_file(uint64_t offset, uint64_t bytes, uint64_t fileSize) {
+    return offset <= fileSize && bytes <= fileSize - offset;
+}
+
+// Bytes the column takes in the file. False when the column could not fit in
+// fileSize bytes, checked before multiplying so nothing here overflows.
+bool column_bytes(const ColumnDescriptor& desc, uint64_t numRows, uint64_t fileSize, uint64_t& bytes) {
+    if (desc.encoding == kEncodingFloat64) {
+        if (numRows > fileSize / sizeof(double)) return false;
+        bytes = numRows * sizeof(double);
+        return true;
+    }
+    if (desc.encoding != kEncodingPacked || desc.bitWidth > 32) return false;
+    uint64_t blocks = numRows / kBitPackBlock + (numRows % kBitPackBlock != 0);
+    uint64_t blockBytes = desc.bitWidth * kBitPackLanes * sizeof(uint32_t);
+    if (blockBytes != 0 && blocks > fileSize / blockBytes) return false;
+    bytes = blocks * blockBytes;
+    return true;
+}
+
+// FNV-1a
+uint64_t hash_bytes(const char* data, size_t size, uint64_t hash) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool read_header(const string& cachePath, FileHeader& header) {
+    ifstream in(cachePath, ios::binary);
+    return in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        && memcmp(header.magic, kMagic, sizeof(kMagic)) == 0
+        && header.version == kVersion;
+}
+
+// Rebuilds the cache when it does not describe the current source file.
+const string& refresh_cache(const string& sourcePath, const string& cachePath) {
+    SourceStamp stamp = stamp_file(sourcePath);
+
+    FileHeader header;
+    if (read_header(cachePath, header)) {
+        SourceStamp cached = {header.sourceSize, header.sourceMtime, header.sourceHash};
+        if (cached == stamp) return cachePath;
+    }
+
+    write_dataset_cache(cachePath, read_machine_data(sourcePath), stamp);
+    return cachePath;
+}
+
+}
+
+// SourceStamp //
+bool SourceStamp::operator==(const SourceStamp& other) const {
+    return size == other.size && mtime == other.mtime && hash == other.hash;
+}
+
+SourceStamp stamp_file(const string& path) {
+    SourceStamp stamp;
+    stamp.size = filesystem::file_size(path);
+    stamp.mtime = static_cast<int64_t>(filesystem::last_write_time(path).time_since_epoch().count());
+
+    ifstream in(path, ios::binary);
+    vector<char> buffer(min<uint64_t>(stamp.size, kHashWindow));
+    in.read(buffer.data(), buffer.size());
+    stamp.hash = hash_bytes(buffer.data(), buffer.size(), 14695981039346656037ULL);
+    if (stamp.size > kHashWindow) {
+        in.seekg(stamp.size - buffer.size());
+        in.read(buffer.data(), buffer.size());
+        stamp.hash = hash_bytes(buffer.data(), buffer.size(), stamp.hash);
+    }
+    if (!in)
+        throw runtime_error("Could not read file: " + path);
+    return stamp;
+}
+
+// ColumnView //
+const double* ColumnView::block(size_t index, double* buffer) const {
+    if (!packed) return data + index * kColumnBlockRows;
+    bitpack_decode(words, reference, bitWidth, index, 1, buffer);
+    return buffer;
+}
+
+// DatasetCache //
+// Constructors
+DatasetCache::DatasetCache(const string& cachePath): mFile(cachePath) {
+    load(cachePath);
+}
+
+DatasetCache::DatasetCache(const string& sourcePath, const string& cachePath):
+    mFile(refresh_cache(sourcePath, cachePath)) {
+    load(cachePath);
+}
+
+void DatasetCache::load(const string& cachePath) {
+    TP_TRACE_SCOPE("load cache");
+    const char* base = mFile.data();
+    if (mFile.size() < sizeof(FileHeader))
+        throw runtime_error("Not a dataset cache: " + cachePath);
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(base);
+    if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion)
+        throw runtime_error("Not a dataset cache: " + cachePath);
+    if (header->numColumns > (mFile.size() - sizeof(FileHeader)) / sizeof(ColumnDescriptor))
+        throw runtime_error("Truncated dataset cache: " + cachePath);
+
+    mNumRows = header->numRows;
+    mStamp = {header->sourceSize, header->sourceMtime, header->sourceHash};
+
+    const ColumnDescriptor* desc = reinterpret_cast<const ColumnDescriptor*>(base + sizeof(FileHeader));
+    for (uint32_t c = 0; c < header->numColumns; ++c) {
+        bool packed = desc[c].encoding == kEncodingPacked;
+        uint64_t bytes;
+        if (desc[c].name[sizeof(desc[c].name) - 1] != '\0' || !column_bytes(desc[c], mNumRows, mFile.size(), bytes)
+            || desc[c].bytes != bytes || desc[c].offset % kAlign != 0 || !in_file(desc[c].offset, bytes, mFile.size()))
+            throw runtime_error("Corrupt column in dataset cache: " + cachePath);
+
+        ColumnView view;
+        view.name = desc[c].name;
+        view.size = mNumRows;
+        view.hasRange = (desc[c].flags & kFlagHasRange) != 0;
+        view.min = desc[c].min;
+        view.max = desc[c].max;
+        view.packed = packed;
+        view.data = packed ? nullptr : reinterpret_cast<const double*>(base + desc[c].offset);
+        view.words = packed ? reinterpret_cast<const uint32_t*>(base + desc[c].offset) : nullptr;
+        view.reference = packed ? static_cast<int64_t>(desc[c].min) : 0;
+        view.bitWidth = packed ? static_cast<int>(desc[c].bitWidth) : 0;
+        mColumns.push_back(view);
+    }
+
+    if (header->dictionaryOffset != 0) {
+        if (!in_file(header->dictionaryOffset, header->dictionaryBytes, mFile.size()))
+            throw runtime_error("Corrupt vendor dictionary in dataset cache: " + cachePath);
+        const char* name = base + header->dictionaryOffset;
+        const char* end = name + header->dictionaryBytes;
+        while (name < end) {
+            const char* nl = static_cast<const char*>(memchr(name, '\n', end - name));
+            if (nl == nullptr) nl = end;
+            mVendorNames.emplace_back(name, nl);
+            name = nl + 1;
+        }
+    }
+}
+
+const ColumnView& DatasetCache::column(int index) const {
+    if (index < 0 || index >= nColumns())
+        throw out_of_range("Column index out of range.");
+    return mColumns[index];
+}
+
+const ColumnView& DatasetCache::column(const string& name) const {
+    for (const auto& col : mColumns) {
+        if (name == col.name) return col;
+    }
+    throw out_of_range("No column named " + name + " in dataset cache.");
+}
+
+void write_dataset_cache(const string& cachePath, const MachineData& data, const SourceStamp& source) {
+    TP_TRACE_SCOPE("write cache");
+    const size_t rows = data.rows();
+    const bool hasErp = data.erp.size() == rows;
+    const bool hasVendors = data.vendors.size() == rows && !data.vendorNames.empty();
+    vector<string> names(MachineData::kColumnNames, MachineData::kColumnNames + MachineData::kNumFeatures + 1);
+    if (hasErp) names.push_back(MachineData::kColumnNames[MachineData::kNumFeatures + 1]);
+    if (hasVendors) names.push_back("VENDOR");
+    const uint32_t numColumns = static_cast<uint32_t>(names.size());
+
+    FileHeader header = {};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.numColumns = numColumns;
+    header.numRows = rows;
+    header.sourceSize = source.size;
+    header.sourceMtime = source.mtime;
+    header.sourceHash = source.hash;
+
+    // Transpose the row-major predictors into columns, then PRP, ERP and the
+    // vendor codes.
+    vector<vector<double>> columns(numColumns, vector<double>(rows));
+    for (size_t i = 0; i < rows; ++i) {
+        for (int j = 0; j < MachineData::kNumFeatures; ++j) {
+            columns[j][i] = data.row(i)[j];
+        }
+        columns[MachineData::kNumFeatures][i] = data.targets[i];
+        if (hasErp) columns[MachineData::kNumFeatures + 1][i] = data.erp[i];
+        if (hasVendors) columns[numColumns - 1][i] = data.vendors[i];
+    }
+
+    // Integer columns are bit packed whenever that is smaller than float64.
+    vector<ColumnDescriptor> desc(numColumns);
+    vector<vector<uint32_t>> packed(numColumns);
+    size_t offset = align_up(sizeof(FileHeader) + numColumns * sizeof(ColumnDescriptor));
+    for (uint32_t c = 0; c < numColumns; ++c) {
+        desc[c] = {};
+        strncpy(desc[c].name, names[c].c_str(), sizeof(desc[c].name) - 1);
+        desc[c].offset = offset;
+        desc[c].bytes = rows * sizeof(double);
+        desc[c].encoding = kEncodingFloat64;
+        if (rows > 0) {
+            auto range = minmax_element(columns[c].begin(), columns[c].end());
+            desc[c].flags = kFlagHasRange;
+            desc[c].min = *range.first;
+            desc[c].max = *range.second;
+        }
+
+        int64_t reference;
+        int bitWidth;
+        if (rows > 0 && bitpack_plan(columns[c].data(), rows, reference, bitWidth)
+            && bitpack_words(rows, bitWidth) * sizeof(uint32_t) < desc[c].bytes) {
+            packed[c].resize(bitpack_words(rows, bitWidth));
+            bitpack_encode(columns[c].data(), rows, reference, bitWidth, packed[c].data());
+            desc[c].encoding = kEncodingPacked;
+            desc[c].bitWidth = bitWidth;
+            desc[c].bytes = packed[c].size() * sizeof(uint32_t);
+        }
+        offset = align_up(offset + desc[c].bytes);
+    }
+
+    string dictionary;
+    if (hasVendors) {
+        for (const string& name : data.vendorNames) dictionary += name + '\n';
+        header.dictionaryOffset = offset;
+        header.dictionaryBytes = dictionary.size();
+    }
+
+    string tmpPath = cachePath + ".tmp";
+    {
+        ofstream out(tmpPath, ios::binary | ios::trunc);
+        if (!out)
+            throw runtime_error("Could not create dataset cache: " + cachePath);
+
+        const char zeros[kAlign] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(desc.data()), numColumns * sizeof(ColumnDescriptor));
+        for (uint32_t c = 0; c < numColumns; ++c) {
+            out.write(zeros, desc[c].offset - static_cast<uint64_t>(out.tellp()));
+            const void* block = desc[c].encoding == kEncodingPacked
+                ? static_cast<const void*>(packed[c].data()) : static_cast<const void*>(columns[c].data());
+            out.write(static_cast<const char*>(block), desc[c].bytes);
+        }
+        if (hasVendors) {
+            out.write(zeros, header.dictionaryOffset - static_cast<uint64_t>(out.tellp()));
+            out.write(dictionary.data(), dictionary.size());
+        }
+        if (!out)
+            throw runtime_error("Could not write dataset cache: " + cachePath);
+    }
+    filesystem::rename(tmpPath, cachePath);
+}
+
+void write_dataset_cache(const string& cachePath, size_t numRows, const vector<string>& columnNames,
+                         const vector<string>& vendorNames, const ColumnBlockFn& fill, unsigned numThreads) {
+    const uint32_t numColumns = static_cast<uint32_t>(columnNames.size());
+    FileHeader header = {};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.numColumns = numColumns;
+    header.numRows = numRows;
+
+    vector<ColumnDescriptor> desc(numColumns);
+    size_t offset = align_up(sizeof(FileHeader) + numColumns * sizeof(ColumnDescriptor));
+    for (uint32_t c = 0; c < numColumns; ++c) {
+        if (columnNames[c].size() >= sizeof(desc[c].name))
+            throw runtime_error("Column name too long for a dataset cache: " + columnNames[c]);
+        desc[c] = {};
+        strncpy(desc[c].name, columnNames[c].c_str(), sizeof(desc[c].name) - 1);
+        desc[c].offset = offset;
+        desc[c].bytes = numRows * sizeof(double);
+        desc[c].encoding = kEncodingFloat64;
+        offset = align_up(offset + desc[c].bytes);
+    }
+
+    string dictionary;
+    for (const string& name : vendorNames) dictionary += name + '\n';
+    if (!vendorNames.empty()) {
+        header.dictionaryOffset = offset;
+        header.dictionaryBytes = dictionary.size();
+        offset += dictionary.size();
+    }
+
+    string tmpPath = cachePath + ".tmp";
+    {
+        ofstream out(tmpPath, ios::binary | ios::trunc);
+        if (!out)
+            throw runtime_error("Could not create dataset cache: " + cachePath);
+        out.seekp(header.dictionaryOffset);
+        out.write(dictionary.data(), dictionary.size());
+        if (!out)
+            throw runtime_error("Could not write dataset cache: " + cachePath);
+    }
+    filesystem::resize_file(tmpPath, offset);
+
+    // Each worker fills its blocks and writes every column slice in place
+    // through its own stream, keeping per-column ranges that are merged below.
+    const size_t numBlocks = (numRows + kWriteBlockRows - 1) / kWriteBlockRows;
+    const unsigned workers = worker_count(numBlocks, numThreads);
+    vector<vector<double>> mins(workers, vector<double>(numColumns, numeric_limits<double>::infinity()));
+    vector<vector<double>> maxs(workers, vector<double>(numColumns, -numeric_limits<double>::infinity()));
+    parallel_ranges(numBlocks, workers, [&](size_t firstBlock, size_t lastBlock, unsigned w) {
+        fstream out(tmpPath, ios::binary | ios::in | ios::out);
+        vector<double> buffer(static_cast<size_t>(numColumns) * kWriteBlockRows);
+        vector<double*> columns(numColumns);
+        for (uint32_t c = 0; c < numColumns; ++c) columns[c] = &buffer[c * kWriteBlockRows];
+
+        for (size_t b = firstBlock; b < lastBlock; ++b) {
+            size_t begin = b * kWriteBlockRows;
+            size_t count = min(kWriteBlockRows, numRows - begin);
+            fill(begin, begin + count, columns.data());
+            for (uint32_t c = 0; c < numColumns; ++c) {
+                auto range = minmax_element(columns[c], columns[c] + count);
+                mins[w][c] = min(mins[w][c], *range.first);
+                maxs[w][c] = max(maxs[w][c], *range.second);
+                out.seekp(desc[c].offset + begin * sizeof(double));
+                out.write(reinterpret_cast<const char*>(columns[c]), count * sizeof(double));
+            }
+        }
+        if (!out)
+            throw runtime_error("Could not write dataset cache: " + cachePath);
+    });
+
+    for (uint32_t c = 0; c < numColumns && numRows > 0; ++c) {
+        desc[c].flags = kFlagHasRange;
+        desc[c].min = mins[0][c];
+        desc[c].max = maxs[0][c];
+        for (unsigned w = 1; w < workers; ++w) {
+            desc[c].min = min(desc[c].min, mins[w][c]);
+            desc[c].max = max(desc[c].max, maxs[w][c]);
+        }
+    }
+    {
+        fstream out(tmpPath, ios::binary | ios::in | ios::out);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(desc.data()), numColumns * sizeof(ColumnDescriptor));
+        if (!out)
+            throw runtime_error("Could not write dataset cache: " + cachePath);
+    }
+    filesystem::rename(tmpPath, cachePath);
+}
@@ -0,0 +1,64 @@
+#include "../include/DatasetSplit.h"
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+// Uniform in [0, bound) by Lemire's multiply-shift: the high half of a 64 x
+// 64-bit product, redrawing the few low halves that would make some results
+// more likely than others.
+uint64_t uniform_below(CounterRng& rng, uint64_t bound) {
+    unsigned __int128 m = static_cast<unsigned __int128>(rng()) * bound;
+    uint64_t low = static_cast<uint64_t>(m);
+    if (low < bound) {
+        uint64_t threshold = -bound % bound;
+        while (low < threshold) {
+            m = static_cast<unsigned __int128>(rng()) * bound;
+            low = static_cast<uint64_t>(m);
+        }
+    }
+    return static_cast<uint64_t>(m >> 64);
+}
+
+}
+
+// CounterRng //
+uint64_t CounterRng::at(uint64_t seed, uint64_t counter) {
+    uint64_t z = seed + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+vector<uint32_t> shuffled_indices(size_t numRows, uint64_t seed) {
+    if (numRows > UINT32_MAX)
+        throw runtime_error("Too many rows for a 32-bit index permutation.");
+
+    vector<uint32_t> order(numRows);
+    iota(order.begin(), order.end(), 0u);
+    CounterRng rng(seed);
+    for (size_t i = numRows; i > 1; --i) {
+        size_t j = static_cast<size_t>(uniform_below(rng, i));
+        swap(order[i - 1], order[j]);
+    }
+    return order;
+}
+
+// DatasetSplit //
+// Constructor
+DatasetSplit::DatasetSplit(size_t numRows, double trainFraction, uint64_t seed):
+    mOrder(shuffled_indices(numRows, seed)) {
+    if (!(trainFraction >= 0.0 && trainFraction <= 1.0))
+        throw runtime_error("Training fraction must be between 0 and 1.");
+    mTrainRows = static_cast<size_t>(numRows * trainFraction);
+}
+
+IndexView DatasetSplit::fold(int f, int k) const {
+    if (k < 1 || f < 0 || f >= k)
+        throw out_of_range("Fold index out of range.");
+    size_t begin = mOrder.size() * f / k;
+    size_t end = mOrder.size() * (f + 1) / k;
+    return IndexView(mOrder.data() + begin, end - begin);
+}
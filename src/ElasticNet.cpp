@@ -0,0 +1,154 @@
+#include "../include/ElasticNet.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+double soft_threshold(double z, double gamma) {
+    if (z > gamma) return z - gamma;
+    if (z < -gamma) return z + gamma;
+    return 0.0;
+}
+
+// Coordinate descent state on the scaled problem.
+class CoordinateDescent
+{
+private:
+    int mP;
+    const vector<double>& mG; // scaled Gram / n, row-major
+    vector<double> mW;
+    vector<double> mGrad;     // Xᵀy/n - G w
+
+public:
+    CoordinateDescent(int p, const vector<double>& G, const vector<double>& c):
+        mP(p), mG(G), mW(p, 0.0), mGrad(c) {}
+
+    const vector<double>& weights() const {return mW;}
+    double gradient(int j) const {return mGrad[j];}
+
+    // One coordinate step; returns the size of the change. A coordinate with
+    // no curvature (an all-zero column without ridge) has no minimiser to
+    // move to and stays at zero.
+    double step(int j, double l1, double l2) {
+        const double Gjj = mG[j * mP + j];
+        if (!(Gjj + l2 > 0.0)) return 0.0;
+        double updated = soft_threshold(mGrad[j] + Gjj * mW[j], l1) / (Gjj + l2);
+        double delta = updated - mW[j];
+        if (delta != 0.0) {
+            const double* Gj = &mG[j * mP];
+            for (int k = 0; k < mP; ++k) mGrad[k] -= Gj[k] * delta;
+            mW[j] = updated;
+        }
+        return fabs(delta);
+    }
+
+    // Sweeps over features until the largest change is below tolerance.
+    void sweep(const vector<int>& features, double l1, double l2, double tolerance, int& budget) {
+        double largest;
+        do {
+            if (budget-- <= 0)
+                throw runtime_error("Coordinate descent did not converge.");
+            largest = 0.0;
+            for (int j : features) largest = max(largest, step(j, l1, l2));
+        } while (largest > tolerance);
+    }
+};
+
+}
+
+ElasticNetPath elastic_net_path(NormalEquationsAccumulator& train, const ElasticNetOptions& options,
+                                NormalEquationsAccumulator* validation) {
+    const int p = train.nFeatures();
+    const double n = static_cast<double>(train.nRows());
+    if (train.nRows() == 0)
+        throw runtime_error("Elastic net needs training rows.");
+    if (!(options.alpha >= 0.0 && options.alpha <= 1.0) || options.numLambdas < 1 || !(options.minRatio > 0.0))
+        throw runtime_error("Invalid elastic net options.");
+
+    // Unit-RMS columns: Gs = S G S / n, c = S Xᵀy / n.
+    const double* G = train.gramData();
+    const double* Xty = train.xtyData();
+    vector<double> scale(p), Gs(static_cast<size_t>(p) * p), c(p);
+    for (int j = 0; j < p; ++j) {
+        double rms = sqrt(G[j * p + j] / n);
+        scale[j] = rms > 0.0 ? 1.0 / rms : 1.0;
+    }
+    for (int i = 0; i < p; ++i) {
+        for (int j = 0; j < p; ++j) Gs[i * p + j] = G[i * p + j] * scale[i] * scale[j] / n;
+        c[i] = Xty[i] * scale[i] / n;
+    }
+
+    // λ_max: the smallest penalty keeping every weight at zero.
+    double cMax = 0.0;
+    for (int j = 0; j < p; ++j) cMax = max(cMax, fabs(c[j]));
+    const double lambdaMax = cMax / max(options.alpha, 1e-3);
+
+    ElasticNetPath path;
+    CoordinateDescent cd(p, Gs, c);
+    double previous = lambdaMax;
+
+    for (int k = 0; k < options.numLambdas; ++k) {
+        double t = options.numLambdas == 1 ? 0.0 : static_cast<double>(k) / (options.numLambdas - 1);
+        double lambda = lambdaMax * pow(options.minRatio, t);
+        double l1 = lambda * options.alpha, l2 = lambda * (1.0 - options.alpha);
+        int budget = options.maxSweeps;
+
+        // Sequential strong rule.
+        vector<int> strong, discarded;
+        for (int j = 0; j < p; ++j) {
+            bool keep = cd.weights()[j] != 0.0 || fabs(cd.gradient(j)) >= options.alpha * (2.0 * lambda - previous);
+            (keep ? strong : discarded).push_back(j);
+        }
+
+        for (;;) {
+            // Cycle on the active set, then confirm with a pass over the strong set.
+            for (;;) {
+                vector<int> active;
+                for (int j : strong) {
+                    if (cd.weights()[j] != 0.0) active.push_back(j);
+                }
+                cd.sweep(active, l1, l2, options.tolerance, budget);
+
+                double largest = 0.0;
+                for (int j : strong) largest = max(largest, cd.step(j, l1, l2));
+                if (largest <= options.tolerance) break;
+            }
+
+            // KKT check on the features the rule discarded.
+            bool violated = false;
+            for (size_t d = 0; d < discarded.size();) {
+                if (fabs(cd.gradient(discarded[d])) > l1 * (1.0 + 1e-12)) {
+                    strong.push_back(discarded[d]);
+                    discarded.erase(discarded.begin() + d);
+                    violated = true;
+                } else {
+                    ++d;
+                }
+            }
+            if (!violated) break;
+        }
+
+        Vector w(p);
+        int nonZeros = 0;
+        for (int j = 0; j < p; ++j) {
+            w[j] = cd.weights()[j] * scale[j];
+            if (cd.weights()[j] != 0.0) ++nonZeros;
+        }
+        path.lambdas.push_back(lambda);
+        path.weights.push_back(w);
+        path.nonZeros.push_back(nonZeros);
+        if (validation) {
+            path.validationRmse.push_back(sqrt(validation->sumSquaredError(w) / validation->nRows()));
+        }
+        previous = lambda;
+    }
+
+    path.best = path.lambdas.size() - 1;
+    if (validation) {
+        path.best = min_element(path.validationRmse.begin(), path.validationRmse.end()) - path.validationRmse.begin();
+    }
+    return path;
+}
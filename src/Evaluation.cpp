@@ -0,0 +1,269 @@
+#include "../include/Evaluation.h"
+#include "../include/Parallel.h"
+#include "../include/Tracing.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const int kLanes = 8;
+
+// Running error sums for one stream of rows.
+struct ErrorStats
+{
+    double n = 0.0;
+    double mean = 0.0, m2 = 0.0; // Welford over the targets
+    double sse = 0.0, sseC = 0.0; // Kahan sum of squared errors and its compensation
+    double sae = 0.0, saeC = 0.0; // Kahan sum of absolute errors
+    double maxError = 0.0;
+
+    static void kahanMerge(double& sum, double& comp, double otherSum, double otherComp) {
+        double t = sum + otherSum;
+        double err = fabs(sum) >= fabs(otherSum) ? (sum - t) + otherSum : (otherSum - t) + sum;
+        sum = t;
+        comp += otherComp - err;
+    }
+
+    // Chan et al.: combine two (n, mean, M2) triples.
+    void merge(const ErrorStats& other) {
+        if (other.n == 0.0) return;
+        double total = n + other.n;
+        double delta = other.mean - mean;
+        mean += delta * other.n / total;
+        m2 += other.m2 + delta * delta * n * other.n / total;
+        n = total;
+        kahanMerge(sse, sseC, other.sse, other.sseC);
+        kahanMerge(sae, saeC, other.sae, other.saeC);
+        if (other.maxError > maxError) maxError = other.maxError;
+    }
+};
+
+// Eight interleaved streams: lane l sees rows l, l + 8, ... of a worker's
+// range. Every update is element-wise across lanes, so the compiler keeps it
+// in vector registers.
+struct LaneStats
+{
+    double n = 0.0;
+    double mean[kLanes] = {}, m2[kLanes] = {};
+    double sse[kLanes] = {}, sseC[kLanes] = {};
+    double sae[kLanes] = {}, saeC[kLanes] = {};
+    double maxError[kLanes] = {};
+
+    void add(const double* pred, const double* y) {
+        n += 1.0;
+        double inv = 1.0 / n;
+        for (int l = 0; l < kLanes; ++l) {
+            double d = y[l] - mean[l];
+            mean[l] += d * inv;
+            m2[l] += d * (y[l] - mean[l]);
+
+            double e = pred[l] - y[l];
+            double a = fabs(e);
+
+            double v = e * e - sseC[l];
+            double t = sse[l] + v;
+            sseC[l] = (t - sse[l]) - v;
+            sse[l] = t;
+
+            v = a - saeC[l];
+            t = sae[l] + v;
+            saeC[l] = (t - sae[l]) - v;
+            sae[l] = t;
+
+            maxError[l] = a > maxError[l] ? a : maxError[l];
+        }
+    }
+
+    ErrorStats lane(int l) const {
+        ErrorStats s;
+        s.n = n;
+        s.mean = mean[l];
+        s.m2 = m2[l];
+        s.sse = sse[l];
+        s.sseC = sseC[l];
+        s.sae = sae[l];
+        s.saeC = saeC[l];
+        s.maxError = maxError[l];
+        return s;
+    }
+};
+
+ErrorStats single_row(double pred, double y) {
+    ErrorStats s;
+    double e = pred - y;
+    s.n = 1.0;
+    s.mean = y;
+    s.sse = e * e;
+    s.sae = fabs(e);
+    s.maxError = fabs(e);
+    return s;
+}
+
+// rowFn(i) gives a pointer to the p features of row i and targetFn(i, t) its
+// target t; every worker calls its own copies, which may keep state such as a
+// decoded block. Each block of eight rows is transposed into a feature-major
+// tile once, so the dot products run across the rows for every target; coef
+// is p x numTargets row-major.
+template <typename RowFn, typename TargetFn>
+vector<RegressionMetrics> evaluate(size_t rows, int p, int numTargets, const double* coef, const double* bias,
+                                   RowFn rowFn, TargetFn targetFn, unsigned numThreads) {
+    TP_TRACE_SCOPE("evaluate");
+    const int T = numTargets;
+    unsigned workers = worker_count(rows, numThreads);
+    vector<vector<ErrorStats>> partial(workers, vector<ErrorStats>(T));
+    parallel_ranges(rows, workers, [&](size_t begin, size_t end, unsigned w) {
+        TP_TRACE_SCOPE("evaluate block");
+        RowFn rowAt = rowFn;
+        TargetFn targetAt = targetFn;
+        vector<double> tile(static_cast<size_t>(p) * kLanes);
+        double pred[kLanes], y[kLanes];
+        vector<LaneStats> lanes(T);
+
+        size_t i = begin;
+        for (; i + kLanes <= end; i += kLanes) {
+            for (int l = 0; l < kLanes; ++l) {
+                const double* x = rowAt(i + l);
+                for (int j = 0; j < p; ++j) tile[j * kLanes + l] = x[j];
+            }
+            for (int t = 0; t < T; ++t) {
+                for (int l = 0; l < kLanes; ++l) {
+                    pred[l] = bias[t];
+                    y[l] = targetAt(i + l, t);
+                }
+                for (int j = 0; j < p; ++j) {
+                    const double c = coef[j * T + t];
+                    const double* x = &tile[j * kLanes];
+                    for (int l = 0; l < kLanes; ++l) pred[l] += c * x[l];
+                }
+                lanes[t].add(pred, y);
+            }
+        }
+
+        vector<ErrorStats>& stats = partial[w];
+        for (int t = 0; t < T; ++t) {
+            for (int l = 0; l < kLanes; ++l) stats[t].merge(lanes[t].lane(l));
+        }
+        for (; i < end; ++i) {
+            const double* x = rowAt(i);
+            for (int t = 0; t < T; ++t) {
+                double sum = bias[t];
+                for (int j = 0; j < p; ++j) sum += coef[j * T + t] * x[j];
+                stats[t].merge(single_row(sum, targetAt(i, t)));
+            }
+        }
+    });
+
+    vector<RegressionMetrics> metrics(T);
+    for (int t = 0; t < T; ++t) {
+        ErrorStats total;
+        for (const auto& part : partial) total.merge(part[t]);
+
+        metrics[t].count = rows;
+        if (rows == 0) continue;
+        double sse = total.sse - total.sseC;
+        metrics[t].rmse = sqrt(sse / total.n);
+        metrics[t].mae = (total.sae - total.saeC) / total.n;
+        metrics[t].r2 = total.m2 > 0.0 ? 1.0 - sse / total.m2 : numeric_limits<double>::quiet_NaN();
+        metrics[t].maxError = total.maxError;
+    }
+    return metrics;
+}
+
+// Rows of numColumns consecutive cache columns starting at firstColumn. The
+// block a row falls in is decoded once and transposed into a row-major tile,
+// so a worker walking its rows in order decodes every block exactly once.
+class CacheRows
+{
+private:
+    const DatasetCache* mCache;
+    int mFirstColumn;
+    int mNumColumns;
+    size_t mBlock;
+    vector<double> mTile;
+    vector<double> mBuffer;
+
+public:
+    CacheRows(const DatasetCache& cache, int firstColumn, int numColumns):
+        mCache(&cache), mFirstColumn(firstColumn), mNumColumns(numColumns), mBlock(SIZE_MAX) {}
+
+    const double* operator()(size_t i) {
+        size_t block = i / kColumnBlockRows;
+        if (block != mBlock) load(block);
+        return &mTile[(i - block * kColumnBlockRows) * mNumColumns];
+    }
+
+private:
+    void load(size_t block) {
+        mTile.resize(kColumnBlockRows * mNumColumns);
+        mBuffer.resize(kColumnBlockRows);
+        size_t count = min(kColumnBlockRows, mCache->rows() - block * kColumnBlockRows);
+        for (int j = 0; j < mNumColumns; ++j) {
+            const double* values = mCache->column(mFirstColumn + j).block(block, mBuffer.data());
+            for (size_t r = 0; r < count; ++r) mTile[r * mNumColumns + j] = values[r];
+        }
+        mBlock = block;
+    }
+};
+
+}
+
+RegressionMetrics evaluate_regression(const Matrix& X, const Vector& Y, const Vector& weights,
+                                      unsigned numThreads) {
+    if (X.nRows() != Y.size() || X.nCols() != weights.size())
+        throw runtime_error("Matrix, target and weight sizes do not match.");
+    if (X.nRows() == 0) return RegressionMetrics();
+
+    const double* y = &Y[0];
+    const double bias = 0.0;
+    return evaluate(X.nRows(), X.nCols(), 1, &weights[0], &bias,
+                    [&](size_t i) {return X[static_cast<int>(i)];},
+                    [y](size_t i, int) {return y[i];}, numThreads)[0];
+}
+
+vector<RegressionMetrics> evaluate_regression(const Matrix& X, const Matrix& Y, const Matrix& weights,
+                                              unsigned numThreads) {
+    if (X.nRows() != Y.nRows() || X.nCols() != weights.nRows() || Y.nCols() != weights.nCols())
+        throw runtime_error("Matrix, target and weight sizes do not match.");
+    const int p = weights.nRows(), T = weights.nCols();
+    if (X.nRows() == 0) return vector<RegressionMetrics>(T);
+
+    vector<double> coef(static_cast<size_t>(p) * T), bias(T, 0.0);
+    for (int j = 0; j < p; ++j) {
+        for (int t = 0; t < T; ++t) coef[j * T + t] = weights[j][t];
+    }
+    return evaluate(X.nRows(), p, T, coef.data(), bias.data(),
+                    [&](size_t i) {return X[static_cast<int>(i)];},
+                    [&](size_t i, int t) {return Y[static_cast<int>(i)][t];}, numThreads);
+}
+
+RegressionMetrics evaluate_regression(const MachineData& data, const Model& model, unsigned numThreads) {
+    if (model.nFeatures() != MachineData::kNumFeatures)
+        throw runtime_error("Model does not have one weight per machine.data predictor.");
+
+    vector<double> coef = model.effectiveWeights();
+    const double bias = model.effectiveBias();
+    const double* y = data.targets.data();
+    return evaluate(data.rows(), MachineData::kNumFeatures, 1, coef.data(), &bias,
+                    [&data](size_t i) {return data.row(i);},
+                    [y](size_t i, int) {return y[i];}, numThreads)[0];
+}
+
+RegressionMetrics evaluate_regression(const DatasetCache& cache, const Model& model, unsigned numThreads) {
+    const int p = MachineData::kNumFeatures;
+    if (model.nFeatures() != p)
+        throw runtime_error("Model does not have one weight per machine.data predictor.");
+    if (cache.nColumns() <= p)
+        throw runtime_error("Dataset cache has no PRP column.");
+
+    vector<double> coef = model.effectiveWeights();
+    const double bias = model.effectiveBias();
+    CacheRows targets(cache, p, 1);
+    return evaluate(cache.rows(), p, 1, coef.data(), &bias, CacheRows(cache, 0, p),
+                    [targets](size_t i, int) mutable {return *targets(i);}, numThreads)[0];
+}
@@ -0,0 +1,161 @@
+#include "../include/FeatureExpansion.h"
+#include "../include/Cholesky.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const int kP = MachineData::kNumFeatures;
+const int kBatch = NormalEquationsAccumulator::kBatchRows;
+
+}
+
+// Constructor: scales, then the term list in a fixed order (intercept,
+// monomials by degree, logs).
+FeatureExpansion::FeatureExpansion(const ExpansionOptions& options, const MachineData& data):
+    mOptions(options), mScales(kP, 1.0) {
+    if (options.degree < 1 || options.degree > 3)
+        throw runtime_error("Expansion degree must be between 1 and 3.");
+
+    if (data.rows() > 0) {
+        vector<double> ss(kP, 0.0);
+        for (size_t i = 0; i < data.rows(); ++i) {
+            for (int j = 0; j < kP; ++j) ss[j] += data.row(i)[j] * data.row(i)[j];
+        }
+        for (int j = 0; j < kP; ++j) {
+            if (ss[j] > 0.0) mScales[j] = sqrt(ss[j] / data.rows());
+        }
+    }
+
+    auto name = [](int input) {
+        return input < kP ? string(MachineData::kColumnNames[input])
+                          : "log(" + string(MachineData::kColumnNames[input - kP]) + ")";
+    };
+    mTerms.push_back(Term{{-1, -1, -1}});
+    mNames.push_back("1");
+    for (int a = 0; a < kP; ++a) {
+        mTerms.push_back(Term{{a, -1, -1}});
+        mNames.push_back(name(a));
+    }
+    if (options.degree >= 2) {
+        for (int a = 0; a < kP; ++a) {
+            for (int b = a; b < kP; ++b) {
+                mTerms.push_back(Term{{a, b, -1}});
+                mNames.push_back(name(a) + "*" + name(b));
+            }
+        }
+    }
+    if (options.degree >= 3) {
+        for (int a = 0; a < kP; ++a) {
+            for (int b = a; b < kP; ++b) {
+                for (int c = b; c < kP; ++c) {
+                    mTerms.push_back(Term{{a, b, c}});
+                    mNames.push_back(name(a) + "*" + name(b) + "*" + name(c));
+                }
+            }
+        }
+    }
+    if (options.logFeatures) {
+        for (int a = 0; a < kP; ++a) {
+            mTerms.push_back(Term{{kP + a, -1, -1}});
+            mNames.push_back(name(kP + a));
+        }
+    }
+}
+
+// Batch kernel: base columns first (scaled, and log1p if needed), then each
+// term column as an element-wise product of up to three of them.
+void FeatureExpansion::accumulate(const double* X, const double* y, size_t numRows,
+                                  NormalEquationsAccumulator& normal) const {
+    const int q = nTerms();
+    if (normal.nFeatures() != q)
+        throw runtime_error("Accumulator does not match the number of expanded terms.");
+
+    vector<double> inputs(static_cast<size_t>(2 * kP) * kBatch);
+    vector<double> tile(static_cast<size_t>(q) * kBatch);
+    double target[kBatch];
+
+    for (size_t first = 0; first < numRows; first += kBatch) {
+        int count = static_cast<int>(min<size_t>(kBatch, numRows - first));
+        const double* B = X + first * kP;
+
+        for (int l = 0; l < count; ++l) {
+            for (int j = 0; j < kP; ++j) inputs[j * count + l] = B[l * kP + j];
+            target[l] = mOptions.logTarget ? log1p(y[first + l]) : y[first + l];
+        }
+        for (int j = 0; j < kP; ++j) {
+            double* in = &inputs[j * count];
+            if (mOptions.logFeatures) {
+                double* out = &inputs[(kP + j) * count];
+                for (int l = 0; l < count; ++l) out[l] = log1p(in[l]);
+            }
+            const double inv = 1.0 / mScales[j];
+            for (int l = 0; l < count; ++l) in[l] *= inv;
+        }
+
+        for (int t = 0; t < q; ++t) {
+            const Term& term = mTerms[t];
+            double* c = &tile[t * count];
+            if (term.inputs[0] < 0) {
+                for (int l = 0; l < count; ++l) c[l] = 1.0;
+                continue;
+            }
+            const double* a = &inputs[term.inputs[0] * count];
+            for (int l = 0; l < count; ++l) c[l] = a[l];
+            for (int k = 1; k < 3 && term.inputs[k] >= 0; ++k) {
+                const double* b = &inputs[term.inputs[k] * count];
+                for (int l = 0; l < count; ++l) c[l] *= b[l];
+            }
+        }
+        normal.addColumns(tile.data(), target, count);
+    }
+}
+
+void FeatureExpansion::expand(const double* x, double* terms) const {
+    double inputs[2 * kP];
+    for (int j = 0; j < kP; ++j) {
+        inputs[j] = x[j] / mScales[j];
+        inputs[kP + j] = log1p(x[j]);
+    }
+    for (int t = 0; t < nTerms(); ++t) {
+        double v = 1.0;
+        for (int k = 0; k < 3 && mTerms[t].inputs[k] >= 0; ++k) v *= inputs[mTerms[t].inputs[k]];
+        terms[t] = v;
+    }
+}
+
+double FeatureExpansion::predict(const double* x, const Vector& weights) const {
+    if (weights.size() != nTerms())
+        throw runtime_error("Weight vector size does not match the number of expanded terms.");
+    vector<double> terms(nTerms());
+    expand(x, terms.data());
+    double sum = 0.0;
+    for (int t = 0; t < nTerms(); ++t) sum += weights[t] * terms[t];
+    return mOptions.logTarget ? expm1(sum) : sum;
+}
+
+NormalEquationsAccumulator accumulate_expanded(const FeatureExpansion& expansion, const MachineData& data,
+                                               unsigned numThreads) {
+    const NormalEquationsAccumulator empty(expansion.nTerms());
+    unsigned workers = worker_count(data.rows(), numThreads);
+    vector<NormalEquationsAccumulator> parts(workers, empty);
+    parallel_ranges(data.rows(), workers, [&](size_t begin, size_t end, unsigned w) {
+        expansion.accumulate(data.row(begin), data.targets.data() + begin, end - begin, parts[w]);
+    });
+
+    NormalEquationsAccumulator total = empty;
+    for (auto& part : parts) total.merge(part);
+    return total;
+}
+
+Vector solve_expanded(NormalEquationsAccumulator& normal, double ridge) {
+    const int q = normal.nFeatures();
+    vector<double> G(normal.gramData(), normal.gramData() + static_cast<size_t>(q) * q);
+    for (int j = 0; j < q; ++j) G[j * q + j] += ridge;
+    Cholesky chol(G.data(), q);
+    return chol.Solve(normal.xty());
+}
@@ -0,0 +1,178 @@
+#include "../include/Instrumentation.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <ostream>
+
+using namespace std;
+
+namespace {
+
+const int kNumOps = static_cast<int>(InstrumentedOp::Count);
+
+const char* const kOpNames[kNumOps] = {
+    "Vector::operator=", "Vector unary +/-", "Vector + Vector", "Vector - Vector", "Vector * Vector",
+    "Vector * scalar",
+    "Matrix::operator=", "Matrix unary +/-", "Matrix + Matrix", "Matrix - Matrix", "Matrix * Matrix",
+    "Matrix * scalar", "Matrix * Vector", "Matrix::swapRows", "Matrix::det", "Matrix::getMinor",
+    "Matrix::inverse", "Matrix::transpose", "Matrix::pseudo_inverse",
+    "LinearSystem::Solve", "PosSymLinSystem::isSymmetric", "PosSymLinSystem::Solve",
+    "GeneralLinSystem::SolveMoorePenrose",
+    "(untimed)",
+};
+
+enum Field {kCalls, kNanoseconds, kFlops, kBytes, kAllocations, kAllocatedBytes, kNumFields};
+
+// Written only by the owning thread; atomics so that a snapshot taken from
+// another thread reads whole values.
+struct CounterBlock
+{
+    atomic<uint64_t> values[kNumOps][kNumFields];
+};
+
+struct Registry
+{
+    mutex lock;
+    vector<CounterBlock*> live;
+    uint64_t retired[kNumOps][kNumFields] = {}; // threads that have exited
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+struct ThreadState
+{
+    CounterBlock block;
+    int current = -1;          // innermost open operation
+    int depth[kNumOps] = {};   // open timers per operation, for recursion
+
+    ThreadState() {
+        for (auto& op : block.values) {
+            for (auto& v : op) v.store(0, memory_order_relaxed);
+        }
+        Registry& r = registry();
+        lock_guard<mutex> guard(r.lock);
+        r.live.push_back(&block);
+    }
+
+    ~ThreadState() {
+        Registry& r = registry();
+        lock_guard<mutex> guard(r.lock);
+        for (int op = 0; op < kNumOps; ++op) {
+            for (int f = 0; f < kNumFields; ++f) r.retired[op][f] += block.values[op][f].load(memory_order_relaxed);
+        }
+        r.live.erase(find(r.live.begin(), r.live.end(), &block));
+    }
+};
+
+ThreadState& thread_state() {
+    thread_local ThreadState state;
+    return state;
+}
+
+void add(ThreadState& state, int op, Field field, uint64_t value) {
+    state.block.values[op][field].fetch_add(value, memory_order_relaxed);
+}
+
+int64_t now_ns() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+// ScopedOpTimer //
+// Constructor and destructor
+ScopedOpTimer::ScopedOpTimer(InstrumentedOp op, uint64_t flops, uint64_t bytes): mOp(static_cast<int>(op)) {
+    ThreadState& state = thread_state();
+    mPrevious = state.current;
+    state.current = mOp;
+    mTimed = state.depth[mOp]++ == 0;
+    add(state, mOp, kCalls, 1);
+    add(state, mOp, kFlops, flops);
+    add(state, mOp, kBytes, bytes);
+    mStart = mTimed ? now_ns() : 0;
+}
+
+ScopedOpTimer::~ScopedOpTimer() {
+    ThreadState& state = thread_state();
+    if (mTimed) add(state, mOp, kNanoseconds, static_cast<uint64_t>(now_ns() - mStart));
+    --state.depth[mOp];
+    state.current = mPrevious;
+}
+
+void instrumentation_add_allocations(uint64_t count, uint64_t bytes) {
+    ThreadState& state = thread_state();
+    int op = state.current >= 0 ? state.current : static_cast<int>(InstrumentedOp::Untimed);
+    add(state, op, kAllocations, count);
+    add(state, op, kAllocatedBytes, bytes);
+}
+
+InstrumentationSnapshot instrumentation_snapshot() {
+    uint64_t totals[kNumOps][kNumFields];
+    {
+        Registry& r = registry();
+        lock_guard<mutex> guard(r.lock);
+        for (int op = 0; op < kNumOps; ++op) {
+            for (int f = 0; f < kNumFields; ++f) {
+                totals[op][f] = r.retired[op][f];
+                for (CounterBlock* block : r.live) totals[op][f] += block->values[op][f].load(memory_order_relaxed);
+            }
+        }
+    }
+
+    InstrumentationSnapshot snapshot;
+    for (int op = 0; op < kNumOps; ++op) {
+        const uint64_t* t = totals[op];
+        if (t[kCalls] == 0 && t[kAllocations] == 0) continue;
+        OpStats stats = {kOpNames[op], t[kCalls], t[kNanoseconds], t[kFlops], t[kBytes],
+                         t[kAllocations], t[kAllocatedBytes]};
+        snapshot.ops.push_back(stats);
+    }
+    return snapshot;
+}
+
+void instrumentation_reset() {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    for (CounterBlock* block : r.live) {
+        for (auto& op : block->values) {
+            for (auto& v : op) v.store(0, memory_order_relaxed);
+        }
+    }
+    for (auto& op : r.retired) {
+        for (auto& v : op) v = 0;
+    }
+}
+
+// InstrumentationSnapshot //
+void InstrumentationSnapshot::printTable(ostream& out) const {
+    char line[256];
+    snprintf(line, sizeof(line), "%-36s %12s %12s %10s %10s %12s %12s\n",
+             "operation", "calls", "time ms", "GFLOP/s", "GB/s", "allocations", "alloc MB");
+    out << line;
+    for (const OpStats& s : ops) {
+        double seconds = s.nanoseconds * 1e-9;
+        double gflops = seconds > 0.0 ? s.flops / seconds / 1e9 : 0.0;
+        double gbps = seconds > 0.0 ? s.bytes / seconds / 1e9 : 0.0;
+        snprintf(line, sizeof(line), "%-36s %12llu %12.3f %10.3f %10.3f %12llu %12.3f\n",
+                 s.name, static_cast<unsigned long long>(s.calls), seconds * 1e3, gflops, gbps,
+                 static_cast<unsigned long long>(s.allocations), s.allocatedBytes / 1e6);
+        out << line;
+    }
+}
+
+void InstrumentationSnapshot::writeJson(ostream& out) const {
+    out << "{\n  \"operations\": [\n";
+    for (size_t i = 0; i < ops.size(); ++i) {
+        const OpStats& s = ops[i];
+        out << "    {\"name\": \"" << s.name << "\", \"calls\": " << s.calls
+            << ", \"nanoseconds\": " << s.nanoseconds << ", \"flops\": " << s.flops
+            << ", \"bytes\": " << s.bytes << ", \"allocations\": " << s.allocations
+            << ", \"allocated_bytes\": " << s.allocatedBytes << "}" << (i + 1 < ops.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
@@ -0,0 +1,229 @@
+#include "../include/KNearestNeighbours.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+const int kP = MachineData::kNumFeatures;
+const size_t kBlock = 256; // distances computed per kernel call
+
+// out[l] = |row (begin + l) - q|² for rows [begin, end) of the feature-major
+// columns. The inner loop runs across rows, so it vectorises.
+void squared_distances(const double* columns, size_t stride, size_t begin, size_t end,
+                       const double* q, double* out) {
+    size_t count = end - begin;
+    for (size_t l = 0; l < count; ++l) out[l] = 0.0;
+    for (int j = 0; j < kP; ++j) {
+        const double* c = columns + j * stride + begin;
+        const double qj = q[j];
+        for (size_t l = 0; l < count; ++l) {
+            double t = c[l] - qj;
+            out[l] += t * t;
+        }
+    }
+}
+
+// The k smallest (distance, position) pairs seen so far, as a max-heap in
+// caller-owned storage so batch queries reuse it.
+class BoundedHeap
+{
+private:
+    vector<pair<double, size_t>>& mItems;
+    size_t mK;
+
+public:
+    BoundedHeap(vector<pair<double, size_t>>& items, size_t k): mItems(items), mK(k) {
+        mItems.clear();
+        mItems.reserve(k);
+    }
+
+    double worst() const {
+        return mItems.size() < mK ? numeric_limits<double>::infinity() : mItems.front().first;
+    }
+
+    void offer(double distance, size_t position) {
+        if (mItems.size() < mK) {
+            mItems.emplace_back(distance, position);
+            push_heap(mItems.begin(), mItems.end());
+        } else if (distance < mItems.front().first) {
+            pop_heap(mItems.begin(), mItems.end());
+            mItems.back() = make_pair(distance, position);
+            push_heap(mItems.begin(), mItems.end());
+        }
+    }
+
+    // Offers rows [begin, end) given their distances.
+    void offerAll(const double* distances, size_t begin, size_t end) {
+        double bound = worst();
+        for (size_t i = begin; i < end; ++i) {
+            if (distances[i - begin] < bound) {
+                offer(distances[i - begin], i);
+                bound = worst();
+            }
+        }
+    }
+
+    void sort() {sort_heap(mItems.begin(), mItems.end());}
+};
+
+}
+
+// Constructor: standardise, then build the tree over a row-major copy and
+// store the columns in tree order.
+KNearestNeighbours::KNearestNeighbours(const MachineData& reference, int k):
+    mK(k), mNumRows(reference.rows()), mMeans(kP, 0.0), mScales(kP, 1.0) {
+    if (k <= 0 || static_cast<size_t>(k) > mNumRows)
+        throw runtime_error("k must be between 1 and the number of reference rows.");
+
+    for (size_t i = 0; i < mNumRows; ++i) {
+        for (int j = 0; j < kP; ++j) mMeans[j] += reference.row(i)[j];
+    }
+    for (int j = 0; j < kP; ++j) mMeans[j] /= mNumRows;
+    vector<double> ss(kP, 0.0);
+    for (size_t i = 0; i < mNumRows; ++i) {
+        for (int j = 0; j < kP; ++j) {
+            double d = reference.row(i)[j] - mMeans[j];
+            ss[j] += d * d;
+        }
+    }
+    for (int j = 0; j < kP; ++j) {
+        double sd = sqrt(ss[j] / mNumRows);
+        mScales[j] = sd > 0.0 ? sd : 1.0;
+    }
+
+    vector<double> points(mNumRows * kP);
+    for (size_t i = 0; i < mNumRows; ++i) {
+        for (int j = 0; j < kP; ++j) {
+            points[i * kP + j] = (reference.row(i)[j] - mMeans[j]) / mScales[j];
+        }
+    }
+    mNodes.reserve(4 * mNumRows / kLeafSize + 1);
+    mOrder.resize(mNumRows);
+    for (size_t i = 0; i < mNumRows; ++i) mOrder[i] = i;
+    build(0, mNumRows, points);
+
+    mColumns.resize(mNumRows * kP);
+    mTargets.resize(mNumRows);
+    for (size_t t = 0; t < mNumRows; ++t) {
+        for (int j = 0; j < kP; ++j) mColumns[j * mNumRows + t] = points[mOrder[t] * kP + j];
+        mTargets[t] = reference.targets[mOrder[t]];
+    }
+}
+
+int KNearestNeighbours::build(size_t begin, size_t end, vector<double>& points) {
+    int id = static_cast<int>(mNodes.size());
+    mNodes.push_back(Node{begin, end, -1, 0.0, -1, -1});
+    if (end - begin <= kLeafSize) return id;
+
+    int dim = 0;
+    double widest = 0.0;
+    for (int j = 0; j < kP; ++j) {
+        double lo = numeric_limits<double>::infinity(), hi = -lo;
+        for (size_t t = begin; t < end; ++t) {
+            double v = points[mOrder[t] * kP + j];
+            lo = min(lo, v);
+            hi = max(hi, v);
+        }
+        if (hi - lo > widest) {
+            widest = hi - lo;
+            dim = j;
+        }
+    }
+    if (widest == 0.0) return id; // all rows identical
+
+    size_t mid = begin + (end - begin) / 2;
+    nth_element(mOrder.begin() + begin, mOrder.begin() + mid, mOrder.begin() + end,
+                [&](size_t a, size_t b) {return points[a * kP + dim] < points[b * kP + dim];});
+    double split = points[mOrder[mid] * kP + dim];
+
+    int left = build(begin, mid, points);
+    int right = build(mid, end, points);
+    mNodes[id].dim = dim;
+    mNodes[id].split = split;
+    mNodes[id].left = left;
+    mNodes[id].right = right;
+    return id;
+}
+
+// Queries
+void KNearestNeighbours::nearest(const double* x, Search search, vector<pair<double, size_t>>& best) const {
+    double q[kP];
+    for (int j = 0; j < kP; ++j) q[j] = (x[j] - mMeans[j]) / mScales[j];
+
+    BoundedHeap heap(best, mK);
+    double block[kBlock];
+    if (search == Search::BruteForce) {
+        for (size_t b = 0; b < mNumRows; b += kBlock) {
+            size_t e = min(mNumRows, b + kBlock);
+            squared_distances(mColumns.data(), mNumRows, b, e, q, block);
+            heap.offerAll(block, b, e);
+        }
+    } else {
+        // Depth-first, nearer child first; the farther child waits on the
+        // stack with the squared distance to its splitting plane. Median
+        // splits keep the depth, and so the stack, below 64 entries.
+        int stack[128];
+        double bounds[128];
+        int top = 0;
+        stack[top] = 0;
+        bounds[top++] = 0.0;
+        while (top > 0) {
+            --top;
+            int id = stack[top];
+            if (bounds[top] >= heap.worst()) continue;
+
+            while (mNodes[id].dim >= 0) {
+                const Node& node = mNodes[id];
+                double diff = q[node.dim] - node.split;
+                stack[top] = diff < 0.0 ? node.right : node.left;
+                bounds[top++] = diff * diff;
+                id = diff < 0.0 ? node.left : node.right;
+            }
+            const Node& leaf = mNodes[id];
+            for (size_t b = leaf.begin; b < leaf.end; b += kBlock) {
+                size_t e = min(leaf.end, b + kBlock);
+                squared_distances(mColumns.data(), mNumRows, b, e, q, block);
+                heap.offerAll(block, b, e);
+            }
+        }
+    }
+    heap.sort();
+}
+
+void KNearestNeighbours::neighbours(const double* x, size_t* indices, double* distances, Search search) const {
+    vector<pair<double, size_t>> best;
+    nearest(x, search, best);
+    for (int i = 0; i < mK; ++i) {
+        indices[i] = mOrder[best[i].second];
+        distances[i] = best[i].first;
+    }
+}
+
+double KNearestNeighbours::predict(const double* x, Search search) const {
+    vector<pair<double, size_t>> best;
+    nearest(x, search, best);
+    double sum = 0.0;
+    for (const auto& item : best) sum += mTargets[item.second];
+    return sum / mK;
+}
+
+vector<double> KNearestNeighbours::predict(const double* X, size_t numRows, Search search,
+                                           unsigned numThreads) const {
+    vector<double> predictions(numRows);
+    parallel_ranges(numRows, numThreads, [&](size_t begin, size_t end, unsigned) {
+        vector<pair<double, size_t>> best;
+        for (size_t i = begin; i < end; ++i) {
+            nearest(X + i * kP, search, best);
+            double sum = 0.0;
+            for (const auto& item : best) sum += mTargets[item.second];
+            predictions[i] = sum / mK;
+        }
+    });
+    return predictions;
+}
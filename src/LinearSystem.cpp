@@ -1,6 +1,8 @@
 #include "../include/LinearSystem.h"
 #include "../include/Vector.h"
 #include "../include/Matrix.h"
+#include "../include/Instrumentation.h"
+#include "../include/Tracing.h"
 #include<iostream>
 #include<cmath>
 
@@ -23,23 +25,29 @@ LinearSystem::~LinearSystem() = default;
 
 // Gaussian elimination
 Vector LinearSystem::Solve() {
+    TP_INSTRUMENT_OP(GaussianSolve, 2.0 * mSize * mSize * mSize / 3 + 2.0 * mSize * mSize,
+                     8.0 * (mSize * mSize + mSize));
     Matrix A = mpA;
     Vector b = mpb;
 
     for (int i = 0; i < mSize; ++i) {
         // Partial pivoting
-        int maxRow = i;
-        for (int k = i+1; k < mSize; ++k) {
-            if (abs(A[k][i]) > abs(A[maxRow][i])) {
-                maxRow = k;
+        {
+            TP_TRACE_SCOPE("gauss pivot");
+            int maxRow = i;
+            for (int k = i+1; k < mSize; ++k) {
+                if (abs(A[k][i]) > abs(A[maxRow][i])) {
+                    maxRow = k;
+                }
             }
-        }
 
-        if (maxRow != i) {
-            A.swapRows(i, maxRow);
-            swap(b[i], b[maxRow]);
+            if (maxRow != i) {
+                A.swapRows(i, maxRow);
+                swap(b[i], b[maxRow]);
+            }
         }
 
+        TP_TRACE_SCOPE("gauss trailing update");
         for (int k = i+1; k < mSize; ++k) {
             double factor = A[k][i] / A[i][i];
             for (int j = i; j < mSize; ++j) {
@@ -50,6 +58,7 @@ Vector LinearSystem::Solve() {
     }
 
     // Back-substitution
+    TP_TRACE_SCOPE("back substitution");
     Vector x(mSize);
     for (int i = mSize-1; i >= 0; --i) {
         x[i] = b[i];
@@ -75,6 +84,7 @@ PosSymLinSystem::~PosSymLinSystem() = default;
 
 // Check Symetric
 bool PosSymLinSystem::isSymmetric(Matrix& A) {
+    TP_INSTRUMENT_OP(SymmetryCheck, 0, 16.0 * A.nRows() * A.nRows());
     int n = A.nRows();
     for (int i = 0; i < n; ++i) {
         for (int j = 0; j < n; ++j) {
@@ -88,6 +98,7 @@ bool PosSymLinSystem::isSymmetric(Matrix& A) {
 
 // Conjugate gradient
 Vector PosSymLinSystem::Solve() {
+    TP_INSTRUMENT_OP(ConjugateGradientSolve, 0, 0);
     Matrix A = mpA;
     Vector b = mpb;
 
@@ -103,6 +114,7 @@ Vector PosSymLinSystem::Solve() {
     rs_old = r * r; // rᵗ * r
 
     for (int i = 0; i < maxIter; ++i) {
+        TP_TRACE_SCOPE("cg iteration");
         Ap = A * p;
         alpha = rs_old / (p * Ap); // α = rᵗr / pᵗAp
 
@@ -136,6 +148,8 @@ GeneralLinSystem::~GeneralLinSystem() = default;
 
 // Moore-Penrose solution: x = A⁺ b
 Vector GeneralLinSystem::SolveMoorePenrose() {
+    TP_INSTRUMENT_OP(MoorePenroseSolve, 0, 0);
+    TP_TRACE_SCOPE("moore-penrose");
     Matrix A_pinv = mpA.pseudo_inverse();
     return A_pinv * mpb;
 }
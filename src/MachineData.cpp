@@ -0,0 +1,204 @@
+#include "../include/MachineData.h"
+#include "../include/Tracing.h"
+#include <algorithm>
+#include <cmath>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+
+const char* const MachineData::kColumnNames[MachineData::kNumFeatures + 2] = {
+    "MYCT", "MMIN", "MMAX", "CACH", "CHMIN", "CHMAX", "PRP", "ERP"
+};
+
+namespace {
+
+// Chunks smaller than this are not worth a thread of their own.
+const size_t kMinChunkBytes = 1 << 16;
+
+// Same behaviour as stod: leading whitespace is skipped, trailing characters
+// are ignored, a token without a number rejects the row and an out of range
+// value is an error.
+bool parse_field(const char* begin, const char* end, double& value) {
+    char* stop;
+    errno = 0;
+    value = strtod(begin, &stop);
+    if (stop == begin || stop > end)
+        return false;
+    if (errno == ERANGE)
+        throw out_of_range("Value out of range in CSV field.");
+    return true;
+}
+
+// The last field may end at the end of the mapping, where strtod must not
+// look further, so it is parsed from a terminated copy.
+bool parse_last_field(const char* begin, const char* end, double& value) {
+    char buffer[64];
+    size_t length = end - begin;
+    if (length >= sizeof(buffer)) return false;
+    memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    return parse_field(buffer, buffer + length, value);
+}
+
+}
+
+// MachineDataReader //
+// Constructor
+MachineDataReader::MachineDataReader(const string& filename, unsigned numThreads): mFile(filename) {
+    const char* data = mFile.data();
+    const char* end = data + mFile.size();
+
+    // Skip header
+    if (mFile.size() == 0) {
+        throw runtime_error("File is empty or missing header");
+    }
+    const char* body = static_cast<const char*>(memchr(data, '\n', mFile.size()));
+    body = body ? body + 1 : end;
+
+    if (numThreads == 0) numThreads = max(1u, thread::hardware_concurrency());
+    size_t bodySize = end - body;
+    size_t numChunks = min<size_t>(numThreads, bodySize / kMinChunkBytes + 1);
+
+    // Chunk boundaries always sit just after a newline, so no line is split.
+    mBounds.assign(numChunks + 1, end);
+    mBounds[0] = body;
+    for (size_t k = 1; k < numChunks; ++k) {
+        const char* nominal = max(mBounds[k - 1], body + bodySize * k / numChunks);
+        const char* nl = static_cast<const char*>(memchr(nominal, '\n', end - nominal));
+        mBounds[k] = nl ? nl + 1 : end;
+    }
+}
+
+void MachineDataReader::parse(const RowFn& rowFn) const {
+    vector<future<void>> workers;
+    for (size_t k = 1; k < numChunks(); ++k) {
+        workers.push_back(async(launch::async, [this, k, &rowFn] {parseChunk(k, rowFn);}));
+    }
+    parseChunk(0, rowFn);
+    for (auto& w : workers) w.get();
+}
+
+void MachineDataReader::parse(const RecordFn& rowFn) const {
+    vector<future<void>> workers;
+    for (size_t k = 1; k < numChunks(); ++k) {
+        workers.push_back(async(launch::async, [this, k, &rowFn] {parseChunk(k, rowFn);}));
+    }
+    parseChunk(0, rowFn);
+    for (auto& w : workers) w.get();
+}
+
+void MachineDataReader::parseChunk(size_t chunk, const RowFn& rowFn) const {
+    TP_TRACE_SCOPE("parse chunk");
+    parse_machine_lines(mBounds[chunk], mBounds[chunk + 1], chunk, rowFn);
+}
+
+void MachineDataReader::parseChunk(size_t chunk, const RecordFn& rowFn) const {
+    TP_TRACE_SCOPE("parse chunk");
+    parse_machine_lines(mBounds[chunk], mBounds[chunk + 1], chunk, rowFn);
+}
+
+namespace {
+
+// Each line is split on ',' the way getline(ss, token, ',') does it: a
+// trailing empty field is not counted. emit(chunk, vendor, vendorLength,
+// features, prp, erp) is called for every kept row.
+template <typename Emit>
+void parse_lines(const char* begin, const char* end, size_t chunk, const Emit& emit) {
+    const size_t numFields = 10;
+    const char* fields[numFields + 1];
+    const char* line = begin;
+
+    while (line < end) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (eol == nullptr) eol = end;
+
+        size_t count = 0;
+        if (eol > line) {
+            fields[count++] = line;
+            for (const char* c = line; c < eol; ++c) {
+                if (*c != ',') continue;
+                if (count <= numFields) fields[count] = c + 1;
+                ++count;
+            }
+            if (eol[-1] == ',') --count;
+        }
+
+        if (count == numFields) {
+            double row[MachineData::kNumFeatures];
+            double prp;
+            bool ok = true;
+            for (int i = 0; i < MachineData::kNumFeatures && ok; ++i) {
+                ok = parse_field(fields[i + 2], fields[i + 3] - 1, row[i]);
+            }
+            if (ok) ok = parse_field(fields[8], fields[9] - 1, prp);
+            double erp;
+            if (ok && !parse_last_field(fields[9], eol, erp)) erp = NAN;
+            if (ok) emit(chunk, fields[0], static_cast<size_t>(fields[1] - 1 - fields[0]), row, prp, erp);
+        }
+
+        line = eol + 1;
+    }
+}
+
+}
+
+void parse_machine_lines(const char* begin, const char* end, size_t chunk, const MachineDataReader::RowFn& rowFn) {
+    parse_lines(begin, end, chunk, [&rowFn](size_t k, const char*, size_t, const double* x, double prp, double) {
+        rowFn(k, x, prp);
+    });
+}
+
+void parse_machine_lines(const char* begin, const char* end, size_t chunk,
+                         const MachineDataReader::RecordFn& rowFn) {
+    parse_lines(begin, end, chunk, rowFn);
+}
+
+MachineData read_machine_data(const string& filename, unsigned numThreads) {
+    MachineDataReader reader(filename, numThreads);
+
+    // Vendor codes are local to each chunk until the chunks are stitched.
+    vector<MachineData> chunks(reader.numChunks());
+    vector<unordered_map<string, int>> lookup(reader.numChunks());
+    reader.parse([&chunks, &lookup](size_t k, const char* vendor, size_t vendorLength,
+                                    const double* x, double prp, double erp) {
+        MachineData& chunk = chunks[k];
+        auto found = lookup[k].emplace(string(vendor, vendorLength), static_cast<int>(chunk.vendorNames.size()));
+        if (found.second) chunk.vendorNames.push_back(found.first->first);
+        chunk.vendors.push_back(found.first->second);
+        chunk.features.insert(chunk.features.end(), x, x + MachineData::kNumFeatures);
+        chunk.targets.push_back(prp);
+        chunk.erp.push_back(erp);
+    });
+
+    // Stitch the chunks together in file order.
+    TP_TRACE_SCOPE("stitch chunks");
+    size_t total = 0;
+    for (const auto& chunk : chunks) total += chunk.rows();
+
+    MachineData result;
+    result.features.reserve(total * MachineData::kNumFeatures);
+    result.targets.reserve(total);
+    result.erp.reserve(total);
+    result.vendors.reserve(total);
+    unordered_map<string, int> vendorCodes;
+    for (const auto& chunk : chunks) {
+        result.features.insert(result.features.end(), chunk.features.begin(), chunk.features.end());
+        result.targets.insert(result.targets.end(), chunk.targets.begin(), chunk.targets.end());
+        result.erp.insert(result.erp.end(), chunk.erp.begin(), chunk.erp.end());
+
+        vector<int> remap(chunk.vendorNames.size());
+        for (size_t v = 0; v < remap.size(); ++v) {
+            auto found = vendorCodes.emplace(chunk.vendorNames[v], static_cast<int>(result.vendorNames.size()));
+            if (found.second) result.vendorNames.push_back(chunk.vendorNames[v]);
+            remap[v] = found.first->second;
+        }
+        for (int code : chunk.vendors) result.vendors.push_back(remap[code]);
+    }
+    return result;
+}
@@ -0,0 +1,81 @@
+#include "../include/MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const string& filename): mData(nullptr), mSize(0), mFile(INVALID_HANDLE_VALUE), mMapping(nullptr) {
+    mFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (mFile == INVALID_HANDLE_VALUE)
+        throw runtime_error("Could not open file: " + filename);
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mFile, &size)) {
+        CloseHandle(mFile);
+        throw runtime_error("Could not stat file: " + filename);
+    }
+    mSize = static_cast<size_t>(size.QuadPart);
+    if (mSize == 0) return;
+
+    mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping == nullptr) {
+        CloseHandle(mFile);
+        throw runtime_error("Could not map file: " + filename);
+    }
+    mData = static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+    if (mData == nullptr) {
+        CloseHandle(mMapping);
+        CloseHandle(mFile);
+        throw runtime_error("Could not map file: " + filename);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (mData) UnmapViewOfFile(mData);
+    if (mMapping) CloseHandle(mMapping);
+    if (mFile != INVALID_HANDLE_VALUE) CloseHandle(mFile);
+}
+
+#else
+
+MappedFile::MappedFile(const string& filename): mData(nullptr), mSize(0), mFd(-1) {
+    mFd = open(filename.c_str(), O_RDONLY);
+    if (mFd < 0)
+        throw runtime_error("Could not open file: " + filename);
+
+    struct stat st;
+    if (fstat(mFd, &st) != 0) {
+        close(mFd);
+        throw runtime_error("Could not stat file: " + filename);
+    }
+    mSize = static_cast<size_t>(st.st_size);
+    if (mSize == 0) return;
+
+    void* addr = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFd, 0);
+    if (addr == MAP_FAILED) {
+        close(mFd);
+        throw runtime_error("Could not map file: " + filename);
+    }
+    madvise(addr, mSize, MADV_SEQUENTIAL);
+    mData = static_cast<const char*>(addr);
+}
+
+MappedFile::~MappedFile() {
+    if (mData) munmap(const_cast<char*>(mData), mSize);
+    if (mFd >= 0) close(mFd);
+}
+
+#endif
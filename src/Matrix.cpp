@@ -1,5 +1,8 @@
 #include "../include/Matrix.h"
 #include "../include/Vector.h"
+#include "../include/Instrumentation.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <Eigen/Dense>
 
@@ -7,6 +10,7 @@ using namespace std;
 
 // Constructor
 Matrix::Matrix(int numRows, int numCols): mNumRows(numRows), mNumCols(numCols) {
+    TP_INSTRUMENT_ALLOCATIONS(mNumRows + 1, (mNumRows + 1.0 * mNumRows * mNumCols) * sizeof(double));
     mData = new double*[mNumRows];
     for(int i = 0; i < mNumRows; i++) {
         mData[i] = new double[mNumCols]{};
@@ -14,6 +18,7 @@ Matrix::Matrix(int numRows, int numCols): mNumRows(numRows), mNumCols(numCols) {
 }
 
 Matrix::Matrix(const Matrix& other): mNumRows(other.mNumRows), mNumCols(other.mNumCols){
+    TP_INSTRUMENT_ALLOCATIONS(mNumRows + 1, (mNumRows + 1.0 * mNumRows * mNumCols) * sizeof(double));
     mData = new double*[mNumRows];
     for(int i = 0; i < mNumRows; i++) {
         mData[i] = new double[mNumCols]{};
@@ -32,6 +37,7 @@ Matrix::~Matrix() {
 
 // Assignment operator
 Matrix& Matrix::operator=(const Matrix& other) {
+    TP_INSTRUMENT_OP(MatrixAssign, 0, 16.0 * other.mNumRows * other.mNumCols);
     if (this != &other) {
         // Clean up old memory
         for (int i = 0; i < mNumRows; ++i)
@@ -42,6 +48,7 @@ Matrix& Matrix::operator=(const Matrix& other) {
         mNumRows = other.mNumRows;
         mNumCols = other.mNumCols;
         mData = new double*[mNumRows];
+        TP_INSTRUMENT_ALLOCATIONS(mNumRows + 1, (mNumRows + 1.0 * mNumRows * mNumCols) * sizeof(double));
         for (int i = 0; i < mNumRows; ++i) {
             mData[i] = new double[mNumCols];
             for (int j = 0; j < mNumCols; ++j)
@@ -53,10 +60,12 @@ Matrix& Matrix::operator=(const Matrix& other) {
 
 //Unary operators
 Matrix Matrix::operator+() const {
+    TP_INSTRUMENT_OP(MatrixUnary, 0, 16.0 * mNumRows * mNumCols);
     return *this;
 }
 
 Matrix Matrix::operator-() const {
+    TP_INSTRUMENT_OP(MatrixUnary, 1.0 * mNumRows * mNumCols, 16.0 * mNumRows * mNumCols);
     Matrix result(mNumRows, mNumCols);
     for (int i = 0; i < mNumRows; i++) {
         for (int j = 0; j < mNumCols; j++) {
@@ -68,6 +77,7 @@ Matrix Matrix::operator-() const {
 
 // Binary operators
 Matrix Matrix::operator+ (Matrix const& other) const {
+    TP_INSTRUMENT_OP(MatrixAdd, 1.0 * mNumRows * mNumCols, 24.0 * mNumRows * mNumCols);
     if (mNumCols != other.mNumCols && mNumRows != other.mNumRows)
         throw runtime_error("Matrix sizes do not match for addition.");
     Matrix result(mNumRows, mNumCols);
@@ -79,6 +89,7 @@ Matrix Matrix::operator+ (Matrix const& other) const {
     return result;
 }
 Matrix Matrix::operator- (Matrix const& other) const {
+    TP_INSTRUMENT_OP(MatrixSubtract, 1.0 * mNumRows * mNumCols, 24.0 * mNumRows * mNumCols);
     if (mNumCols != other.mNumCols && mNumRows != other.mNumRows)
         throw runtime_error("Matrix sizes do not match for subtraction");
     Matrix result(mNumRows, mNumCols);
@@ -90,6 +101,8 @@ Matrix Matrix::operator- (Matrix const& other) const {
     return result;
 }
 Matrix Matrix::operator* (Matrix const& other) const {
+    TP_INSTRUMENT_OP(MatrixMultiply, 2.0 * mNumRows * mNumCols * other.mNumCols,
+                     8.0 * (mNumRows * mNumCols + other.mNumRows * other.mNumCols + mNumRows * other.mNumCols));
     if (mNumCols != other.mNumRows)
         throw runtime_error("Matrix sizes do not match for multiplication");
     Matrix result(mNumRows, other.mNumCols);
@@ -105,6 +118,7 @@ Matrix Matrix::operator* (Matrix const& other) const {
 
 // Scalar multiplication
 Matrix Matrix::operator* (double scalar) const {
+    TP_INSTRUMENT_OP(MatrixScale, 1.0 * mNumRows * mNumCols, 16.0 * mNumRows * mNumCols);
     Matrix result(mNumRows, mNumCols);
     for (int i = 0; i < mNumRows; i++) {
         for (int j = 0; j < mNumCols; j++) {
@@ -116,6 +130,7 @@ Matrix Matrix::operator* (double scalar) const {
 
 // Matrix-Vector multiplication
 Vector Matrix::operator* (Vector& other) const {
+    TP_INSTRUMENT_OP(MatrixVector, 2.0 * mNumRows * mNumCols, 8.0 * (mNumRows * mNumCols + mNumRows + mNumCols));
     if (mNumCols != other.size()) {
         throw std::runtime_error("Matrix and vector sizes are incompatible for multiplication.");
     }
@@ -169,6 +184,7 @@ void Matrix::print() const {
     }
 }
 void Matrix::swapRows(int rIndex1, int rIndex2) {
+    TP_INSTRUMENT_OP(MatrixSwapRows, 0, 32.0 * mNumCols);
     if (rIndex1 < 0 || rIndex2 < 0 || rIndex1 >= mNumRows || rIndex2 >= mNumRows) {
         throw std::out_of_range("Row index out of bounds");
     }
@@ -180,6 +196,7 @@ void Matrix::swapRows(int rIndex1, int rIndex2) {
 
 // Matrix function
 double Matrix::det() const{
+    TP_INSTRUMENT_OP(MatrixDet, 2.0 * mNumRows, 8.0 * mNumRows);
     if (mNumRows != mNumCols)
         throw runtime_error("Matrix sizes do not match for calculating determinant");
 
@@ -195,6 +212,7 @@ double Matrix::det() const{
 }   
 
 Matrix Matrix::getMinor(int row, int col) const{
+    TP_INSTRUMENT_OP(MatrixMinor, 0, 16.0 * (mNumRows - 1) * (mNumCols - 1));
     Matrix result(mNumRows - 1, mNumCols -1);
 
     for(int i = 0, minorRow = 0; i < mNumRows; i++) {
@@ -210,6 +228,7 @@ Matrix Matrix::getMinor(int row, int col) const{
 }
 
 Matrix Matrix::inverse() const{
+    TP_INSTRUMENT_OP(MatrixInverse, 0, 0);
     if (mNumRows != mNumCols)
         throw runtime_error("Matrix sizes do not match for calculating inverse");
 
@@ -232,6 +251,7 @@ Matrix Matrix::inverse() const{
 }
 
 Matrix Matrix::transpose() const{
+    TP_INSTRUMENT_OP(MatrixTranspose, 0, 16.0 * mNumRows * mNumCols);
     Matrix result(mNumCols, mNumRows);
     for (int i = 0; i < mNumRows; i++) {
         for (int j = 0; j < mNumCols; j++) {
@@ -242,6 +262,10 @@ Matrix Matrix::transpose() const{
 }   
 
 Matrix Matrix::pseudo_inverse() const {
+    // Thin SVD of an m x n matrix, k = min(m, n): about 4mnk + 8k³ flops.
+    TP_INSTRUMENT_OP(MatrixPseudoInverse, 4.0 * mNumRows * mNumCols * min(mNumRows, mNumCols)
+                     + 8.0 * pow(min(mNumRows, mNumCols), 3), 16.0 * mNumRows * mNumCols);
+
     // Convert your Matrix to an Eigen::MatrixXd
     Eigen::MatrixXd eigenMat(mNumRows, mNumCols);
     for (int i = 0; i < mNumRows; ++i) {
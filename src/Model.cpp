@@ -0,0 +1,117 @@
+#include "../include/Model.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const char kMagic[8] = {'T', 'P', 'M', 'O', 'D', 'E', 'L', '1'};
+const uint32_t kVersion = 1;
+const size_t kNameBytes = 16;
+
+}
+
+// Constructors
+Model::Model(const vector<string>& names, const Vector& weights):
+    mNames(names), mWeights(weights.size()), mMeans(weights.size(), 0.0), mScales(weights.size(), 1.0),
+    mIntercept(0.0) {
+    if (names.size() != mWeights.size())
+        throw runtime_error("Model needs one name per weight.");
+    for (int j = 0; j < weights.size(); ++j) mWeights[j] = weights[j];
+    fold();
+}
+
+Model::Model(const vector<string>& names, const vector<double>& weights,
+             const vector<double>& means, const vector<double>& scales, double intercept):
+    mNames(names), mWeights(weights), mMeans(means), mScales(scales), mIntercept(intercept) {
+    if (names.size() != weights.size() || means.size() != weights.size() || scales.size() != weights.size())
+        throw runtime_error("Model needs a name, mean and scale per weight.");
+    for (double s : scales) {
+        if (s == 0.0)
+            throw runtime_error("Model scale must not be zero.");
+    }
+    fold();
+}
+
+void Model::fold() {
+    mCoef = effectiveWeights();
+    mBias = effectiveBias();
+}
+
+// Serialisation
+void Model::save(const string& filename) const {
+    ofstream out(filename, ios::binary | ios::trunc);
+    if (!out)
+        throw runtime_error("Could not create model file: " + filename);
+
+    uint32_t version = kVersion, numFeatures = static_cast<uint32_t>(mWeights.size());
+    out.write(kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char*>(&numFeatures), sizeof(numFeatures));
+    out.write(reinterpret_cast<const char*>(&mIntercept), sizeof(mIntercept));
+    for (size_t j = 0; j < mWeights.size(); ++j) {
+        char name[kNameBytes] = {};
+        strncpy(name, mNames[j].c_str(), kNameBytes - 1);
+        out.write(name, kNameBytes);
+        out.write(reinterpret_cast<const char*>(&mWeights[j]), sizeof(double));
+        out.write(reinterpret_cast<const char*>(&mMeans[j]), sizeof(double));
+        out.write(reinterpret_cast<const char*>(&mScales[j]), sizeof(double));
+    }
+    if (!out)
+        throw runtime_error("Could not write model file: " + filename);
+}
+
+Model Model::load(const string& filename) {
+    ifstream in(filename, ios::binary);
+    if (!in)
+        throw runtime_error("Could not open model file: " + filename);
+
+    char magic[sizeof(kMagic)];
+    uint32_t version = 0, numFeatures = 0;
+    double intercept = 0.0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&numFeatures), sizeof(numFeatures));
+    in.read(reinterpret_cast<char*>(&intercept), sizeof(intercept));
+    if (!in || memcmp(magic, kMagic, sizeof(kMagic)) != 0 || version != kVersion || numFeatures > 4096)
+        throw runtime_error("Not a model file: " + filename);
+
+    vector<string> names(numFeatures);
+    vector<double> weights(numFeatures), means(numFeatures), scales(numFeatures);
+    for (uint32_t j = 0; j < numFeatures; ++j) {
+        char name[kNameBytes];
+        in.read(name, kNameBytes);
+        name[kNameBytes - 1] = '\0';
+        names[j] = name;
+        in.read(reinterpret_cast<char*>(&weights[j]), sizeof(double));
+        in.read(reinterpret_cast<char*>(&means[j]), sizeof(double));
+        in.read(reinterpret_cast<char*>(&scales[j]), sizeof(double));
+    }
+    if (!in)
+        throw runtime_error("Truncated model file: " + filename);
+    return Model(names, weights, means, scales, intercept);
+}
+
+// Prediction
+vector<double> Model::effectiveWeights() const {
+    vector<double> coef(mWeights.size());
+    for (size_t j = 0; j < coef.size(); ++j) coef[j] = mWeights[j] / mScales[j];
+    return coef;
+}
+
+double Model::effectiveBias() const {
+    double bias = mIntercept;
+    for (size_t j = 0; j < mWeights.size(); ++j) bias -= mWeights[j] * mMeans[j] / mScales[j];
+    return bias;
+}
+
+double Model::predict(const double* features) const {
+    double sum = mIntercept;
+    for (size_t j = 0; j < mWeights.size(); ++j) {
+        sum += mWeights[j] * (features[j] - mMeans[j]) / mScales[j];
+    }
+    return sum;
+}
@@ -0,0 +1,213 @@
+#include "../include/NormalEquations.h"
+#include "../include/Cholesky.h"
+#include "../include/MachineData.h"
+#include "../include/Parallel.h"
+#include "../include/Tracing.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXd;
+
+// Constructor
+NormalEquationsAccumulator::NormalEquationsAccumulator(int numFeatures):
+    mNumFeatures(numFeatures), mNumRows(0),
+    mXtX(static_cast<size_t>(numFeatures) * numFeatures, 0.0), mXty(numFeatures, 0.0), mYty(0.0),
+    mBatch(static_cast<size_t>(kBatchRows) * numFeatures), mBatchY(kBatchRows), mBatchCount(0) {
+    if (numFeatures <= 0)
+        throw runtime_error("Number of features must be positive.");
+}
+
+void NormalEquationsAccumulator::addRow(const double* x, double y) {
+    double* dst = &mBatch[static_cast<size_t>(mBatchCount) * mNumFeatures];
+    for (int j = 0; j < mNumFeatures; ++j) {
+        dst[j] = x[j];
+    }
+    mBatchY[mBatchCount] = y;
+    if (++mBatchCount == kBatchRows) flush();
+}
+
+void NormalEquationsAccumulator::addRows(const double* X, const double* y, size_t numRows) {
+    for (size_t i = 0; i < numRows; ++i) {
+        addRow(X + i * mNumFeatures, y[i]);
+    }
+}
+
+void NormalEquationsAccumulator::addColumns(const double* columns, const double* y, int count) {
+    if (count <= 0) return;
+    flush();
+
+    const int p = mNumFeatures;
+    Eigen::Map<const RowMatrixXd> C(columns, p, count);
+    Eigen::Map<const Eigen::VectorXd> yC(y, count);
+    Eigen::Map<RowMatrixXd> XtX(mXtX.data(), p, p);
+    Eigen::Map<Eigen::VectorXd> Xty(mXty.data(), p);
+
+    XtX.selfadjointView<Eigen::Lower>().rankUpdate(C);
+    Xty.noalias() += C * yC;
+    mYty += yC.squaredNorm();
+    mNumRows += count;
+}
+
+// Rank-k update: XᵀX += BᵀB, Xᵀy += Bᵀy_B for the pending batch B. Eigen's
+// symmetric rank update and GEMV run vectorised on the batch.
+void NormalEquationsAccumulator::flush() {
+    if (mBatchCount == 0) return;
+
+    const int p = mNumFeatures;
+    Eigen::Map<const RowMatrixXd> B(mBatch.data(), mBatchCount, p);
+    Eigen::Map<const Eigen::VectorXd> yB(mBatchY.data(), mBatchCount);
+    Eigen::Map<RowMatrixXd> XtX(mXtX.data(), p, p);
+    Eigen::Map<Eigen::VectorXd> Xty(mXty.data(), p);
+
+    XtX.selfadjointView<Eigen::Lower>().rankUpdate(B.transpose());
+    Xty.noalias() += B.transpose() * yB;
+    mYty += yB.squaredNorm();
+
+    mNumRows += mBatchCount;
+    mBatchCount = 0;
+}
+
+void NormalEquationsAccumulator::merge(NormalEquationsAccumulator& other) {
+    if (other.mNumFeatures != mNumFeatures)
+        throw runtime_error("Accumulators have a different number of features.");
+    flush();
+    other.flush();
+    for (size_t k = 0; k < mXtX.size(); ++k) {
+        mXtX[k] += other.mXtX[k];
+    }
+    for (int j = 0; j < mNumFeatures; ++j) {
+        mXty[j] += other.mXty[j];
+    }
+    mYty += other.mYty;
+    mNumRows += other.mNumRows;
+}
+
+void NormalEquationsAccumulator::subtract(NormalEquationsAccumulator& other) {
+    if (other.mNumFeatures != mNumFeatures)
+        throw runtime_error("Accumulators have a different number of features.");
+    flush();
+    other.flush();
+    if (other.mNumRows > mNumRows)
+        throw runtime_error("Cannot subtract more rows than were accumulated.");
+    for (size_t k = 0; k < mXtX.size(); ++k) {
+        mXtX[k] -= other.mXtX[k];
+    }
+    for (int j = 0; j < mNumFeatures; ++j) {
+        mXty[j] -= other.mXty[j];
+    }
+    mYty -= other.mYty;
+    mNumRows -= other.mNumRows;
+}
+
+// Results
+const double* NormalEquationsAccumulator::gramData() {
+    flush();
+    for (int i = 0; i < mNumFeatures; ++i) {
+        for (int j = i + 1; j < mNumFeatures; ++j) {
+            mXtX[i * mNumFeatures + j] = mXtX[j * mNumFeatures + i];
+        }
+    }
+    return mXtX.data();
+}
+
+const double* NormalEquationsAccumulator::xtyData() {
+    flush();
+    return mXty.data();
+}
+
+Matrix NormalEquationsAccumulator::gram() {
+    const double* G = gramData();
+    Matrix result(mNumFeatures, mNumFeatures);
+    for (int i = 0; i < mNumFeatures; ++i) {
+        for (int j = 0; j < mNumFeatures; ++j) {
+            result[i][j] = G[i * mNumFeatures + j];
+        }
+    }
+    return result;
+}
+
+Vector NormalEquationsAccumulator::xty() {
+    flush();
+    Vector result(mNumFeatures);
+    for (int j = 0; j < mNumFeatures; ++j) {
+        result[j] = mXty[j];
+    }
+    return result;
+}
+
+double NormalEquationsAccumulator::yty() {
+    flush();
+    return mYty;
+}
+
+Vector NormalEquationsAccumulator::solve() {
+    TP_TRACE_SCOPE("solve");
+    Cholesky chol(gramData(), mNumFeatures);
+    return chol.Solve(xty());
+}
+
+double NormalEquationsAccumulator::sumSquaredError(const Vector& weights) {
+    if (weights.size() != mNumFeatures)
+        throw runtime_error("Weight vector size does not match the number of features.");
+    const double* G = gramData();
+
+    double sse = mYty;
+    for (int i = 0; i < mNumFeatures; ++i) {
+        double Gw = 0.0;
+        for (int j = 0; j < mNumFeatures; ++j) {
+            Gw += G[i * mNumFeatures + j] * weights[j];
+        }
+        sse += weights[i] * (Gw - 2.0 * mXty[i]);
+    }
+    // Cancellation can leave a tiny negative value for a perfect fit.
+    return sse > 0.0 ? sse : 0.0;
+}
+
+NormalEquationsAccumulator accumulate_machine_data(const string& filename, unsigned numThreads) {
+    MachineDataReader reader(filename, numThreads);
+
+    vector<NormalEquationsAccumulator> parts(reader.numChunks(), NormalEquationsAccumulator(MachineData::kNumFeatures));
+    reader.parse([&parts](size_t k, const double* x, double prp) {
+        parts[k].addRow(x, prp);
+    });
+
+    TP_TRACE_SCOPE("gram merge");
+    for (size_t k = 1; k < parts.size(); ++k) {
+        parts[0].merge(parts[k]);
+    }
+    parts[0].flush();
+    return parts[0];
+}
+
+NormalEquationsAccumulator accumulate_dataset_cache(const DatasetCache& cache, unsigned numThreads) {
+    const int p = MachineData::kNumFeatures;
+    if (cache.nColumns() <= p)
+        throw runtime_error("Dataset cache has no PRP column.");
+    TP_TRACE_SCOPE("gram build");
+
+    const size_t rows = cache.rows();
+    const size_t numBlocks = cache.column(0).numBlocks();
+    unsigned workers = worker_count(numBlocks, numThreads);
+    vector<NormalEquationsAccumulator> parts(workers, NormalEquationsAccumulator(p));
+    parallel_ranges(numBlocks, workers, [&](size_t firstBlock, size_t lastBlock, unsigned w) {
+        vector<double> buffer(kColumnBlockRows), columns(p * kColumnBlockRows), y(kColumnBlockRows);
+        for (size_t b = firstBlock; b < lastBlock; ++b) {
+            size_t count = min(kColumnBlockRows, rows - b * kColumnBlockRows);
+            for (int j = 0; j < p; ++j) {
+                const double* values = cache.column(j).block(b, buffer.data());
+                copy(values, values + count, &columns[j * count]);
+            }
+            const double* prp = cache.column(p).block(b, buffer.data());
+            copy(prp, prp + count, y.data());
+            parts[w].addColumns(columns.data(), y.data(), static_cast<int>(count));
+        }
+    });
+
+    for (unsigned w = 1; w < workers; ++w) {
+        parts[0].merge(parts[w]);
+    }
+    return parts[0];
+}
@@ -0,0 +1,105 @@
+#include "../include/OneHotRegression.h"
+#include "../include/Cholesky.h"
+#include "../include/Parallel.h"
+#include <stdexcept>
+
+using namespace std;
+
+// OneHotFit //
+double OneHotFit::predict(const double* x, int category) const {
+    double sum = category >= 0 && static_cast<size_t>(category) < offsets.size() ? offsets[category] : meanOffset;
+    for (size_t j = 0; j < weights.size(); ++j) sum += weights[j] * x[j];
+    return sum;
+}
+
+// OneHotNormalEquations //
+// Constructor
+OneHotNormalEquations::OneHotNormalEquations(int numFeatures, int numCategories):
+    mDense(numFeatures), mNumCategories(numCategories),
+    mSums(static_cast<size_t>(numCategories) * numFeatures, 0.0),
+    mCounts(numCategories, 0.0), mTargetSums(numCategories, 0.0) {
+    if (numCategories <= 0)
+        throw runtime_error("Number of categories must be positive.");
+}
+
+void OneHotNormalEquations::addRow(const double* x, int category, double y) {
+    if (category < 0 || category >= mNumCategories)
+        throw out_of_range("Category code out of range.");
+    mDense.addRow(x, y);
+
+    const int p = nFeatures();
+    double* sums = &mSums[static_cast<size_t>(category) * p];
+    for (int j = 0; j < p; ++j) sums[j] += x[j];
+    mCounts[category] += 1.0;
+    mTargetSums[category] += y;
+}
+
+void OneHotNormalEquations::merge(OneHotNormalEquations& other) {
+    if (other.mNumCategories != mNumCategories)
+        throw runtime_error("Accumulators have a different number of categories.");
+    mDense.merge(other.mDense);
+    for (size_t k = 0; k < mSums.size(); ++k) mSums[k] += other.mSums[k];
+    for (int v = 0; v < mNumCategories; ++v) {
+        mCounts[v] += other.mCounts[v];
+        mTargetSums[v] += other.mTargetSums[v];
+    }
+}
+
+OneHotFit OneHotNormalEquations::solve(double ridge) {
+    const int p = nFeatures();
+    vector<double> S(mDense.gramData(), mDense.gramData() + static_cast<size_t>(p) * p);
+    vector<double> rhs(mDense.xtyData(), mDense.xtyData() + p);
+
+    // Schur complement of the diagonal category block: one rank-1 term per
+    // category, s_v s_vᵀ / d_v.
+    for (int v = 0; v < mNumCategories; ++v) {
+        double d = mCounts[v] + ridge;
+        if (d <= 0.0) continue; // no rows and no ridge: the category drops out
+        const double* s = &mSums[static_cast<size_t>(v) * p];
+        double inv = 1.0 / d;
+        for (int i = 0; i < p; ++i) {
+            double si = s[i] * inv;
+            for (int j = 0; j < p; ++j) S[i * p + j] -= si * s[j];
+            rhs[i] -= si * mTargetSums[v];
+        }
+    }
+
+    OneHotFit fit;
+    fit.weights = rhs;
+    Cholesky(S.data(), p).solveInPlace(fit.weights.data());
+
+    // Back-substitute the category offsets.
+    fit.offsets.assign(mNumCategories, 0.0);
+    double weighted = 0.0, total = 0.0;
+    for (int v = 0; v < mNumCategories; ++v) {
+        double d = mCounts[v] + ridge;
+        if (d <= 0.0) continue;
+        const double* s = &mSums[static_cast<size_t>(v) * p];
+        double r = mTargetSums[v];
+        for (int j = 0; j < p; ++j) r -= s[j] * fit.weights[j];
+        fit.offsets[v] = r / d;
+        weighted += mCounts[v] * fit.offsets[v];
+        total += mCounts[v];
+    }
+    fit.meanOffset = total > 0.0 ? weighted / total : 0.0;
+    for (int v = 0; v < mNumCategories; ++v) {
+        if (mCounts[v] + ridge <= 0.0) fit.offsets[v] = fit.meanOffset;
+    }
+    return fit;
+}
+
+OneHotNormalEquations accumulate_vendor_equations(const MachineData& data, unsigned numThreads) {
+    if (data.vendors.size() != data.rows() || data.vendorNames.empty())
+        throw runtime_error("Data has no vendor codes.");
+
+    const OneHotNormalEquations empty(MachineData::kNumFeatures, static_cast<int>(data.vendorNames.size()));
+    unsigned workers = worker_count(data.rows(), numThreads);
+    vector<OneHotNormalEquations> parts(workers, empty);
+    parallel_ranges(data.rows(), workers, [&](size_t begin, size_t end, unsigned w) {
+        for (size_t i = begin; i < end; ++i) parts[w].addRow(data.row(i), data.vendors[i], data.targets[i]);
+    });
+
+    OneHotNormalEquations total = empty;
+    for (auto& part : parts) total.merge(part);
+    return total;
+}
@@ -0,0 +1,70 @@
+#include "../include/OnlineRegression.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+vector<double> scaled_identity(int size, double value) {
+    vector<double> A(static_cast<size_t>(size) * size, 0.0);
+    for (int i = 0; i < size; ++i) A[i * size + i] = value;
+    return A;
+}
+
+}
+
+// Constructor
+OnlineRegression::OnlineRegression(int numFeatures, double forgetting, double initialRidge):
+    mNumFeatures(numFeatures), mForgetting(forgetting),
+    mChol(scaled_identity(numFeatures, initialRidge).data(), numFeatures),
+    mXty(numFeatures, 0.0), mWeights(numFeatures, 0.0), mSolved(true), mNumRows(0) {
+    if (!(forgetting > 0.0 && forgetting <= 1.0))
+        throw runtime_error("Forgetting factor must be in (0, 1].");
+}
+
+void OnlineRegression::addRow(const double* x, double y) {
+    if (mForgetting != 1.0) {
+        mChol.scale(mForgetting);
+        for (double& b : mXty) b *= mForgetting;
+    }
+    mChol.update(x);
+    for (int j = 0; j < mNumFeatures; ++j) {
+        mXty[j] += x[j] * y;
+    }
+    ++mNumRows;
+    mSolved = false;
+}
+
+void OnlineRegression::removeRow(const double* x, double y) {
+    if (mNumRows == 0)
+        throw runtime_error("No rows to remove.");
+    mChol.downdate(x);
+    for (int j = 0; j < mNumFeatures; ++j) {
+        mXty[j] -= x[j] * y;
+    }
+    --mNumRows;
+    mSolved = false;
+}
+
+void OnlineRegression::solve() {
+    if (mSolved) return;
+    mWeights = mXty;
+    mChol.solveInPlace(mWeights.data());
+    mSolved = true;
+}
+
+double OnlineRegression::predict(const double* x) {
+    solve();
+    double sum = 0.0;
+    for (int j = 0; j < mNumFeatures; ++j) {
+        sum += mWeights[j] * x[j];
+    }
+    return sum;
+}
+
+Vector OnlineRegression::weights() {
+    solve();
+    Vector result(mNumFeatures);
+    for (int j = 0; j < mNumFeatures; ++j) result[j] = mWeights[j];
+    return result;
+}
@@ -0,0 +1,104 @@
+#include "../include/OutOfCore.h"
+#include "../include/MachineData.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Lines longer than this do not fit the carry-over buffer.
+const size_t kMaxLineBytes = 1 << 12;
+
+size_t read_block(ifstream* in, char* buffer, size_t size) {
+    in->read(buffer, size);
+    return static_cast<size_t>(in->gcount());
+}
+
+}
+
+// Constructor
+// Two blocks share the budget; the line carried between blocks and the
+// accumulators are small and fixed.
+OutOfCoreTrainer::OutOfCoreTrainer(size_t memoryBudget, size_t holdoutEvery):
+    mBlockBytes(memoryBudget / 2), mHoldoutEvery(holdoutEvery), mRowsSeen(0),
+    mTrain(MachineData::kNumFeatures), mHoldout(MachineData::kNumFeatures) {
+    if (mBlockBytes < 2 * kMaxLineBytes)
+        throw runtime_error("Memory budget too small for out-of-core training.");
+    mBlockBytes -= kMaxLineBytes;
+}
+
+void OutOfCoreTrainer::addRow(const double* features, double prp) {
+    if (mHoldoutEvery != 0 && ++mRowsSeen % mHoldoutEvery == 0) {
+        mHoldout.addRow(features, prp);
+    } else {
+        mTrain.addRow(features, prp);
+    }
+}
+
+void OutOfCoreTrainer::train(const string& filename) {
+    ifstream in(filename, ios::binary);
+    if (!in)
+        throw runtime_error("Could not open file: " + filename);
+
+    vector<char> buffers[2] = {vector<char>(mBlockBytes), vector<char>(mBlockBytes)};
+    string carry;        // partial line left at the end of the previous block
+    bool inHeader = true;
+    auto rowFn = [this](size_t, const double* x, double prp) { addRow(x, prp); };
+
+    size_t current = 0;
+    future<size_t> pending = async(launch::async, read_block, &in, buffers[0].data(), mBlockBytes);
+    size_t total = 0;
+    for (;;) {
+        size_t got = pending.get();
+        if (got == 0) break;
+        total += got;
+
+        // Start reading the next block before parsing this one.
+        pending = async(launch::async, read_block, &in, buffers[1 - current].data(), mBlockBytes);
+
+        const char* begin = buffers[current].data();
+        const char* end = begin + got;
+        const char* firstNl = static_cast<const char*>(memchr(begin, '\n', got));
+        const char* lastNl = end - 1;
+        while (firstNl && *lastNl != '\n') --lastNl;
+
+        if (firstNl == nullptr) {
+            // The whole block belongs to the carried line.
+            if (!inHeader) carry.append(begin, end);
+        } else {
+            // Finish the carried line, then everything up to the last newline.
+            if (inHeader) {
+                inHeader = false;
+            } else {
+                carry.append(begin, firstNl);
+                parse_machine_lines(carry.data(), carry.data() + carry.size(), 0, rowFn);
+            }
+            parse_machine_lines(firstNl + 1, lastNl + 1, 0, rowFn);
+            carry.assign(lastNl + 1, end);
+        }
+        if (carry.size() > kMaxLineBytes)
+            throw runtime_error("Line too long for out-of-core training.");
+
+        current = 1 - current;
+    }
+
+    if (total == 0)
+        throw runtime_error("File is empty or missing header");
+    if (!inHeader && !carry.empty())
+        parse_machine_lines(carry.data(), carry.data() + carry.size(), 0, rowFn);
+}
+
+Vector OutOfCoreTrainer::solve() {
+    return mTrain.solve();
+}
+
+double OutOfCoreTrainer::holdoutRmse(const Vector& weights) {
+    if (mHoldout.nRows() == 0)
+        throw runtime_error("No holdout rows to compute RMSE on.");
+    return sqrt(mHoldout.sumSquaredError(weights) / mHoldout.nRows());
+}
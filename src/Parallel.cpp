@@ -0,0 +1,30 @@
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+unsigned worker_count(size_t count, unsigned numThreads) {
+    if (numThreads == 0) numThreads = max(1u, thread::hardware_concurrency());
+    return static_cast<unsigned>(max<size_t>(1, min<size_t>(numThreads, count)));
+}
+
+void parallel_ranges(size_t count, unsigned numThreads,
+                     const function<void(size_t, size_t, unsigned)>& fn) {
+    unsigned workers = worker_count(count, numThreads);
+
+    vector<future<void>> pending;
+    for (unsigned w = 1; w < workers; ++w) {
+        pending.push_back(async(launch::async, fn, count * w / workers, count * (w + 1) / workers, w));
+    }
+    fn(0, count / workers, 0);
+    for (auto& p : pending) p.get();
+}
+
+void parallel_for(size_t count, unsigned numThreads, const function<void(size_t)>& fn) {
+    parallel_ranges(count, numThreads, [&fn](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) fn(i);
+    });
+}
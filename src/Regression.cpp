@@ -0,0 +1,91 @@
+#include "../include/Regression.h"
+#include "../include/Cholesky.h"
+#include "../include/NormalEquations.h"
+#include "../include/Tracing.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXd;
+
+Vector solve_linear_regression(Matrix& X, Vector& Y) {
+    if (X.nRows() != Y.size()) {
+        throw runtime_error("Matrix and vector sizes are incompatible.");
+    }
+
+    // Step 1: Accumulate XᵀX and XᵀY row by row (no transposed copy of X)
+    NormalEquationsAccumulator normal(X.nCols());
+    {
+        TP_TRACE_SCOPE("gram build");
+        for (int i = 0; i < X.nRows(); ++i) {
+            normal.addRow(X[i], Y[i]);
+        }
+        normal.flush();
+    }
+
+    // Step 2: Solve (XᵀX) w = XᵀY by Cholesky
+    return normal.solve();
+}
+
+Matrix solve_linear_regression(Matrix& X, Matrix& Y) {
+    if (X.nRows() != Y.nRows()) {
+        throw runtime_error("Design and target matrices have a different number of rows.");
+    }
+    const int p = X.nCols(), t = Y.nCols();
+    const int batch = NormalEquationsAccumulator::kBatchRows;
+
+    // Step 1: XᵀX and XᵀY, gathering the row pointers of X and Y into batches
+    RowMatrixXd XtX = RowMatrixXd::Zero(p, p), XtY = RowMatrixXd::Zero(p, t);
+    {
+        TP_TRACE_SCOPE("gram build");
+        RowMatrixXd B(batch, p), YB(batch, t);
+        for (int first = 0; first < X.nRows(); first += batch) {
+            int count = min(batch, X.nRows() - first);
+            for (int i = 0; i < count; ++i) {
+                copy(X[first + i], X[first + i] + p, B.row(i).data());
+                copy(Y[first + i], Y[first + i] + t, YB.row(i).data());
+            }
+            XtX.selfadjointView<Eigen::Lower>().rankUpdate(B.topRows(count).transpose());
+            XtY.noalias() += B.topRows(count).transpose() * YB.topRows(count);
+        }
+    }
+
+    // Step 2: one Cholesky factorisation, all targets solved together
+    TP_TRACE_SCOPE("solve");
+    Cholesky chol(XtX.data(), p);
+    chol.solveInPlace(XtY.data(), t);
+
+    Matrix W(p, t);
+    for (int j = 0; j < p; ++j) {
+        copy(XtY.row(j).data(), XtY.row(j).data() + t, W[j]);
+    }
+    return W;
+}
+
+Vector predict(Matrix& X, Vector& weights) {
+    TP_TRACE_SCOPE("predict");
+    return X * weights;
+}
+
+Matrix predict(Matrix& X, Matrix& weights) {
+    TP_TRACE_SCOPE("predict");
+    return X * weights;
+}
+
+double compute_rmse(const Vector& predicted, const Vector& actual) {
+    if (predicted.size() != actual.size()) {
+        throw runtime_error("Vectors must be the same size for RMSE calculation.");
+    }
+    TP_TRACE_SCOPE("rmse");
+
+    double sum_squared_error = 0.0;
+    for (int i = 0; i < predicted.size(); ++i) {
+        double diff = predicted[i] - actual[i];
+        sum_squared_error += diff * diff;
+    }
+
+    return sqrt(sum_squared_error / predicted.size());
+}
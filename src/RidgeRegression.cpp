@@ -0,0 +1,76 @@
+#include "../include/RidgeRegression.h"
+#include "../include/Parallel.h"
+#include <Eigen/Dense>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXd;
+
+RidgePath ridge_path(NormalEquationsAccumulator& train, NormalEquationsAccumulator& validation,
+                     const vector<double>& lambdas, unsigned numThreads) {
+    const int p = train.nFeatures();
+    if (validation.nFeatures() != p)
+        throw runtime_error("Accumulators have a different number of features.");
+    if (train.nRows() == 0 || validation.nRows() == 0)
+        throw runtime_error("Ridge path needs training and validation rows.");
+    if (lambdas.empty())
+        throw runtime_error("Ridge path needs at least one penalty.");
+
+    // Scale every column to unit RMS: Gs = S G S, bs = S Xᵀy with S = diag(1/s).
+    Eigen::Map<const RowMatrixXd> G(train.gramData(), p, p);
+    Eigen::Map<const Eigen::VectorXd> Xty(train.xtyData(), p);
+    Eigen::VectorXd scale(p);
+    for (int j = 0; j < p; ++j) {
+        double rms = sqrt(G(j, j) / train.nRows());
+        scale(j) = rms > 0.0 ? 1.0 / rms : 1.0;
+    }
+    Eigen::MatrixXd Gs = scale.asDiagonal() * G * scale.asDiagonal();
+
+    // One eigendecomposition for the whole path.
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eig(Gs);
+    if (eig.info() != Eigen::Success)
+        throw runtime_error("Eigendecomposition of the Gram matrix failed.");
+    const Eigen::MatrixXd& V = eig.eigenvectors();
+    const Eigen::VectorXd& d = eig.eigenvalues();
+    Eigen::VectorXd c = V.transpose() * scale.cwiseProduct(Xty);
+
+    // Make sure the validation Gram is complete before threads read it.
+    validation.gramData();
+
+    RidgePath path;
+    path.lambdas = lambdas;
+    path.weights.assign(lambdas.size(), Vector(p));
+    path.validationRmse.assign(lambdas.size(), 0.0);
+
+    parallel_for(lambdas.size(), numThreads, [&](size_t k) {
+        if (lambdas[k] < 0.0)
+            throw runtime_error("Ridge penalty must not be negative.");
+        Eigen::VectorXd ws = V * (c.array() / (d.array() + lambdas[k])).matrix();
+
+        Vector w(p);
+        for (int j = 0; j < p; ++j) w[j] = ws(j) * scale(j);
+
+        NormalEquationsAccumulator held = validation;
+        path.validationRmse[k] = sqrt(held.sumSquaredError(w) / held.nRows());
+        path.weights[k] = w;
+    });
+
+    path.best = 0;
+    for (size_t k = 1; k < lambdas.size(); ++k) {
+        if (path.validationRmse[k] < path.validationRmse[path.best]) path.best = k;
+    }
+    return path;
+}
+
+vector<double> log_spaced_lambdas(double lo, double hi, int count) {
+    if (!(lo > 0.0) || !(hi >= lo) || count < 1)
+        throw runtime_error("Penalty range must satisfy 0 < lo <= hi.");
+    vector<double> lambdas(count);
+    for (int k = 0; k < count; ++k) {
+        double t = count == 1 ? 0.0 : static_cast<double>(k) / (count - 1);
+        lambdas[k] = lo * pow(hi / lo, t);
+    }
+    return lambdas;
+}
@@ -0,0 +1,214 @@
+#include "../include/ScoringEngine.h"
+#include "../include/MappedFile.h"
+#include "../include/Parallel.h"
+#include <Eigen/Dense>
+#include <charconv>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+using namespace std;
+
+typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrixXd;
+
+namespace {
+
+// Rows per GEMV call; keeps the working set in cache.
+const size_t kRowBlock = 4096;
+
+void write_predictions(const double* values, size_t count, ostream& out, bool textOutput) {
+    if (!textOutput) {
+        out.write(reinterpret_cast<const char*>(values), count * sizeof(double));
+        return;
+    }
+    string text;
+    text.reserve(count * 12);
+    char buffer[32];
+    for (size_t i = 0; i < count; ++i) {
+        to_chars_result r = to_chars(buffer, buffer + sizeof(buffer), values[i]);
+        text.append(buffer, r.ptr);
+        text.push_back('\n');
+    }
+    out.write(text.data(), text.size());
+}
+
+// Neither mapped files nor stdin slices are terminated, so a field is copied
+// into a terminated buffer before strtod sees it. The whole field must be the
+// number; leading whitespace is allowed, as with strtod.
+bool parse_field(const char* begin, const char* end, double& value) {
+    char buffer[64];
+    size_t length = end - begin;
+    if (length == 0 || length >= sizeof(buffer)) return false;
+    memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    char* next;
+    errno = 0;
+    value = strtod(buffer, &next);
+    return next == buffer + length && next != buffer && errno != ERANGE;
+}
+
+}
+
+const size_t ScoringEngine::kSliceBytes;
+
+// Constructor
+ScoringEngine::ScoringEngine(const Model& model, unsigned numThreads):
+    mNumFeatures(model.nFeatures()), mCoef(model.effectiveWeights()), mBias(model.effectiveBias()),
+    mNumThreads(numThreads) {
+    if (mNumFeatures == 0)
+        throw runtime_error("Model has no features.");
+}
+
+void ScoringEngine::scoreRows(const double* X, size_t numRows, double* out) const {
+    Eigen::Map<const Eigen::VectorXd> coef(mCoef.data(), mNumFeatures);
+    for (size_t first = 0; first < numRows; first += kRowBlock) {
+        size_t count = min(kRowBlock, numRows - first);
+        Eigen::Map<const RowMatrixXd> block(X + first * mNumFeatures, count, mNumFeatures);
+        Eigen::Map<Eigen::VectorXd> y(out + first, count);
+        y.noalias() = block * coef;
+        y.array() += mBias;
+    }
+}
+
+// Parses CSV lines in [begin, end) (complete lines only), then scores the
+// parsed rows in one batch. Blank lines score as NaN like any other invalid
+// line, so there is one prediction per input line.
+void ScoringEngine::scoreCsv(const char* begin, const char* end, vector<double>& predictions) const {
+    vector<double> rows;
+    vector<size_t> invalid;
+    const char* line = begin;
+    while (line < end) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', end - line));
+        if (eol == nullptr) eol = end;
+        const char* stop = eol;
+        if (stop > line && stop[-1] == '\r') --stop;
+
+        bool ok = stop > line;
+        const char* field = line;
+        for (int j = 0; j < mNumFeatures; ++j) {
+            const char* comma = ok ? static_cast<const char*>(memchr(field, ',', stop - field)) : nullptr;
+            const char* fieldEnd = comma ? comma : stop;
+            double value = 0.0;
+            ok = ok && parse_field(field, fieldEnd, value) && (j + 1 < mNumFeatures) == (comma != nullptr);
+            rows.push_back(ok ? value : 0.0);
+            field = fieldEnd + 1;
+        }
+        if (!ok) invalid.push_back(rows.size() / mNumFeatures - 1);
+        line = eol + 1;
+    }
+
+    predictions.resize(rows.size() / mNumFeatures);
+    scoreRows(rows.data(), predictions.size(), predictions.data());
+    for (size_t i : invalid) predictions[i] = NAN;
+}
+
+size_t ScoringEngine::scoreSlice(const char* begin, const char* end, FeatureFormat format,
+                                 ostream& out, bool textOutput) const {
+    size_t size = end - begin;
+    if (format == FeatureFormat::Binary) {
+        const size_t rowBytes = mNumFeatures * sizeof(double);
+        size_t numRows = size / rowBytes;
+
+        // Copy only when the slice is not aligned for doubles (stdin buffers are).
+        const double* X = reinterpret_cast<const double*>(begin);
+        vector<double> aligned;
+        if (reinterpret_cast<uintptr_t>(begin) % alignof(double) != 0) {
+            aligned.resize(numRows * mNumFeatures);
+            memcpy(aligned.data(), begin, numRows * rowBytes);
+            X = aligned.data();
+        }
+
+        vector<double> predictions(numRows);
+        parallel_ranges(numRows, mNumThreads, [&](size_t first, size_t last, unsigned) {
+            scoreRows(X + first * mNumFeatures, last - first, predictions.data() + first);
+        });
+        write_predictions(predictions.data(), numRows, out, textOutput);
+        return numRows;
+    }
+
+    // CSV: per-thread ranges start and end on line boundaries.
+    unsigned workers = worker_count(size / 4096 + 1, mNumThreads);
+    vector<const char*> bounds(workers + 1, end);
+    bounds[0] = begin;
+    for (unsigned w = 1; w < workers; ++w) {
+        const char* nominal = max(bounds[w - 1], begin + size * w / workers);
+        const char* nl = static_cast<const char*>(memchr(nominal, '\n', end - nominal));
+        bounds[w] = nl ? nl + 1 : end;
+    }
+
+    vector<vector<double>> predictions(workers);
+    parallel_for(workers, workers, [&](size_t w) {
+        scoreCsv(bounds[w], bounds[w + 1], predictions[w]);
+    });
+
+    size_t numRows = 0;
+    for (const auto& part : predictions) {
+        write_predictions(part.data(), part.size(), out, textOutput);
+        numRows += part.size();
+    }
+    return numRows;
+}
+
+size_t ScoringEngine::scoreFile(const string& filename, FeatureFormat format, ostream& out, bool textOutput) const {
+    MappedFile file(filename);
+    const char* data = file.data();
+    const char* end = data + file.size();
+    const size_t rowBytes = mNumFeatures * sizeof(double);
+
+    if (format == FeatureFormat::Binary && file.size() % rowBytes != 0)
+        throw runtime_error("Binary feature file is not a whole number of rows: " + filename);
+
+    size_t numRows = 0;
+    const char* slice = data;
+    while (slice < end) {
+        const char* sliceEnd;
+        if (format == FeatureFormat::Binary) {
+            sliceEnd = slice + min<size_t>(end - slice, kSliceBytes / rowBytes * rowBytes);
+        } else {
+            const char* nominal = slice + min<size_t>(end - slice, kSliceBytes);
+            const char* nl = nominal < end ? static_cast<const char*>(memchr(nominal, '\n', end - nominal)) : nullptr;
+            sliceEnd = nl ? nl + 1 : end;
+        }
+        numRows += scoreSlice(slice, sliceEnd, format, out, textOutput);
+        slice = sliceEnd;
+    }
+    return numRows;
+}
+
+size_t ScoringEngine::scoreStream(istream& in, FeatureFormat format, ostream& out, bool textOutput) const {
+    const size_t rowBytes = mNumFeatures * sizeof(double);
+    vector<double> storage(kSliceBytes / sizeof(double) + 1);
+    char* buffer = reinterpret_cast<char*>(storage.data());
+
+    size_t numRows = 0, carried = 0;
+    for (;;) {
+        in.read(buffer + carried, kSliceBytes - carried);
+        size_t filled = carried + static_cast<size_t>(in.gcount());
+        if (filled == 0) break;
+        bool last = !in;
+
+        // Keep a trailing partial row / line for the next read.
+        size_t usable = filled;
+        if (!last) {
+            if (format == FeatureFormat::Binary) {
+                usable = filled / rowBytes * rowBytes;
+            } else {
+                while (usable > 0 && buffer[usable - 1] != '\n') --usable;
+                if (usable == 0)
+                    throw runtime_error("CSV line longer than the scoring buffer.");
+            }
+        } else if (format == FeatureFormat::Binary && filled % rowBytes != 0) {
+            throw runtime_error("Binary feature stream is not a whole number of rows.");
+        }
+
+        numRows += scoreSlice(buffer, buffer + usable, format, out, textOutput);
+        carried = filled - usable;
+        memmove(buffer, buffer + usable, carried);
+        if (last) break;
+    }
+    return numRows;
+}
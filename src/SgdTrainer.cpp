@@ -0,0 +1,232 @@
+#include "../include/SgdTrainer.h"
+#include "../include/MachineData.h"
+#include "../include/Parallel.h"
+#include "../include/Regression.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+// Weights shared by all workers, in the scaled problem.
+typedef unique_ptr<atomic<double>[]> SharedWeights;
+
+// One Hogwild worker: collects scaled rows into a mini-batch and applies the
+// optimizer step for it to the shared weights.
+class Worker
+{
+private:
+    const SgdOptions& mOpt;
+    int mNumFeatures;
+    atomic<double>* mShared;
+    const double* mXScale;
+    double mYScale;
+
+    vector<double> mBatchX; // feature-major: mBatchX[j * batchSize + b]
+    vector<double> mBatchY;
+    size_t mCount;
+
+    vector<double> mW, mGrad, mM, mV;
+    long long mStep;
+
+public:
+    Worker(const SgdOptions& opt, int numFeatures, atomic<double>* shared, const double* xScale, double yScale):
+        mOpt(opt), mNumFeatures(numFeatures), mShared(shared), mXScale(xScale), mYScale(yScale),
+        mBatchX(numFeatures * opt.batchSize, 0.0), mBatchY(opt.batchSize, 0.0), mCount(0),
+        mW(numFeatures), mGrad(numFeatures), mM(numFeatures, 0.0), mV(numFeatures, 0.0), mStep(0) {}
+
+    void add(const double* x, double y) {
+        for (int j = 0; j < mNumFeatures; ++j) {
+            mBatchX[j * mOpt.batchSize + mCount] = x[j] * mXScale[j];
+        }
+        mBatchY[mCount] = y * mYScale;
+        if (++mCount == mOpt.batchSize) apply();
+    }
+
+    void apply() {
+        if (mCount == 0) return;
+        const size_t B = mOpt.batchSize;
+        const int p = mNumFeatures;
+
+        for (int j = 0; j < p; ++j) mW[j] = mShared[j].load(memory_order_relaxed);
+
+        // Pad a short final batch with zero rows, which add nothing.
+        for (size_t b = mCount; b < B; ++b) {
+            mBatchY[b] = 0.0;
+            for (int j = 0; j < p; ++j) mBatchX[j * B + b] = 0.0;
+        }
+
+        // Residuals r = Xw - y (overwriting y), then the gradient 2Xᵀr / count.
+        // Every loop runs across the batch.
+        double* res = mBatchY.data();
+        for (size_t b = 0; b < B; ++b) res[b] = -res[b];
+        for (int j = 0; j < p; ++j) {
+            const double* xj = &mBatchX[j * B];
+            for (size_t b = 0; b < B; ++b) res[b] += xj[b] * mW[j];
+        }
+        for (int j = 0; j < p; ++j) {
+            const double* xj = &mBatchX[j * B];
+            double part[4] = {0.0, 0.0, 0.0, 0.0};
+            size_t b = 0;
+            for (; b + 4 <= B; b += 4) {
+                part[0] += xj[b] * res[b];
+                part[1] += xj[b + 1] * res[b + 1];
+                part[2] += xj[b + 2] * res[b + 2];
+                part[3] += xj[b + 3] * res[b + 3];
+            }
+            for (; b < B; ++b) part[0] += xj[b] * res[b];
+            mGrad[j] = 2.0 * (part[0] + part[1] + part[2] + part[3]) / mCount;
+        }
+
+        ++mStep;
+        const double lr = mOpt.learningRate;
+        for (int j = 0; j < p; ++j) {
+            double g = mGrad[j];
+            double delta;
+            switch (mOpt.optimizer) {
+            case SgdOptimizer::Momentum:
+                mM[j] = mOpt.momentum * mM[j] + g;
+                delta = -lr * mM[j];
+                break;
+            case SgdOptimizer::Adam: {
+                mM[j] = mOpt.beta1 * mM[j] + (1.0 - mOpt.beta1) * g;
+                mV[j] = mOpt.beta2 * mV[j] + (1.0 - mOpt.beta2) * g * g;
+                double mHat = mM[j] / (1.0 - pow(mOpt.beta1, static_cast<double>(mStep)));
+                double vHat = mV[j] / (1.0 - pow(mOpt.beta2, static_cast<double>(mStep)));
+                delta = -lr * mHat / (sqrt(vHat) + mOpt.epsilon);
+                break;
+            }
+            default:
+                delta = -lr * g;
+            }
+            // Hogwild: no lock and no compare-and-swap.
+            mShared[j].store(mShared[j].load(memory_order_relaxed) + delta, memory_order_relaxed);
+        }
+        mCount = 0;
+    }
+};
+
+// Inverse root-mean-square of every column, from sums of squares.
+void finish_scales(vector<double>& xScale, double& yScale, size_t rows) {
+    if (rows == 0)
+        throw runtime_error("No training rows.");
+    for (double& s : xScale) s = s > 0.0 ? 1.0 / sqrt(s / rows) : 1.0;
+    yScale = yScale > 0.0 ? 1.0 / sqrt(yScale / rows) : 1.0;
+}
+
+// Epoch loop shared by train and trainFile: runEpoch performs one pass with
+// the given workers, then the validation RMSE decides whether to go on.
+template <class EpochFn>
+SgdResult run_epochs(const SgdOptions& opt, int p, const vector<double>& xScale, double yScale,
+                     Matrix& X_val, Vector& Y_val, EpochFn runEpoch) {
+    if (X_val.nCols() != p || X_val.nRows() != Y_val.size() || Y_val.size() == 0)
+        throw runtime_error("Validation set does not match the training data.");
+    if (opt.batchSize == 0)
+        throw runtime_error("Batch size must be positive.");
+
+    SharedWeights shared(new atomic<double>[p]);
+    for (int j = 0; j < p; ++j) shared[j].store(0.0);
+
+    unsigned numWorkers = opt.numThreads == 0 ? worker_count(~size_t(0), 0) : opt.numThreads;
+    vector<unique_ptr<Worker>> workers;
+    for (unsigned w = 0; w < numWorkers; ++w) {
+        workers.emplace_back(new Worker(opt, p, shared.get(), xScale.data(), yScale));
+    }
+
+    SgdResult result;
+    result.weights = Vector(p);
+    result.validationRmse = INFINITY;
+    result.epochs = 0;
+    int sinceBest = 0;
+    Vector w(p);
+
+    for (int epoch = 0; epoch < opt.maxEpochs && sinceBest < opt.patience; ++epoch) {
+        runEpoch(workers);
+        for (auto& worker : workers) worker->apply();
+
+        for (int j = 0; j < p; ++j) w[j] = shared[j].load() * xScale[j] / yScale;
+        double rmse = compute_rmse(predict(X_val, w), Y_val);
+        result.history.push_back(rmse);
+        result.epochs = epoch + 1;
+
+        if (rmse < result.validationRmse) {
+            result.validationRmse = rmse;
+            result.weights = w;
+            sinceBest = 0;
+        } else {
+            ++sinceBest;
+        }
+    }
+    return result;
+}
+
+}
+
+// Constructor
+SgdTrainer::SgdTrainer(const SgdOptions& options): mOptions(options) {}
+
+SgdResult SgdTrainer::train(Matrix& X, Vector& Y, Matrix& X_val, Vector& Y_val) {
+    const int p = X.nCols();
+    const size_t n = X.nRows();
+    if (static_cast<size_t>(Y.size()) != n)
+        throw runtime_error("Matrix and vector sizes are incompatible.");
+
+    vector<double> xScale(p, 0.0);
+    double yScale = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        for (int j = 0; j < p; ++j) xScale[j] += X[i][j] * X[i][j];
+        yScale += Y[i] * Y[i];
+    }
+    finish_scales(xScale, yScale, n);
+
+    vector<size_t> order(n);
+    iota(order.begin(), order.end(), 0);
+    int epoch = 0;
+
+    return run_epochs(mOptions, p, xScale, yScale, X_val, Y_val, [&](vector<unique_ptr<Worker>>& workers) {
+        parallel_ranges(n, static_cast<unsigned>(workers.size()), [&](size_t begin, size_t end, unsigned w) {
+            mt19937_64 rng(mOptions.seed + 1000003ULL * epoch + w);
+            shuffle(order.begin() + begin, order.begin() + end, rng);
+            for (size_t k = begin; k < end; ++k) {
+                workers[w]->add(X[order[k]], Y[order[k]]);
+            }
+        });
+        ++epoch;
+    });
+}
+
+SgdResult SgdTrainer::trainFile(const string& filename, Matrix& X_val, Vector& Y_val) {
+    const int p = MachineData::kNumFeatures;
+    unsigned numWorkers = mOptions.numThreads == 0 ? worker_count(~size_t(0), 0) : mOptions.numThreads;
+    MachineDataReader reader(filename, numWorkers);
+
+    // First pass: column scales.
+    vector<vector<double>> sums(reader.numChunks(), vector<double>(p + 2, 0.0));
+    reader.parse([&sums, p](size_t k, const double* x, double y) {
+        for (int j = 0; j < p; ++j) sums[k][j] += x[j] * x[j];
+        sums[k][p] += y * y;
+        sums[k][p + 1] += 1.0;
+    });
+    vector<double> xScale(p, 0.0);
+    double yScale = 0.0, rows = 0.0;
+    for (const auto& s : sums) {
+        for (int j = 0; j < p; ++j) xScale[j] += s[j];
+        yScale += s[p];
+        rows += s[p + 1];
+    }
+    finish_scales(xScale, yScale, static_cast<size_t>(rows));
+
+    SgdOptions opt = mOptions;
+    opt.numThreads = static_cast<unsigned>(reader.numChunks());
+    return run_epochs(opt, p, xScale, yScale, X_val, Y_val, [&](vector<unique_ptr<Worker>>& workers) {
+        reader.parse([&workers](size_t k, const double* x, double y) {
+            workers[k]->add(x, y);
+        });
+    });
+}
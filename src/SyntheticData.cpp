@@ -0,0 +1,197 @@
+#include "../include/SyntheticData.h"
+#include "../include/DatasetCache.h"
+#include "../include/DatasetSplit.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const int kDrawsPerRow = 16;
+const size_t kCsvBlockRows = 1 << 15;
+const size_t kMaxLineBytes = 256; // vendor, model name and eight 64-bit integers fit easily
+const double kTwoPi = 6.283185307179586;
+
+// Fitted to data/machine.data: mean and standard deviation of log x over the
+// non-zero values, correlation of log x with the size factor (log MMAX), the
+// share of zeros and the observed range.
+struct FeatureShape
+{
+    double logMean;
+    double logSd;
+    double loading;
+    double zeroFraction;
+    double min;
+    double max;
+};
+
+const FeatureShape kShapes[MachineData::kNumFeatures] = {
+    {4.75, 1.04, -0.63, 0.0, 17.0, 1500.0},   // MYCT
+    {7.36, 1.10, 0.73, 0.0, 64.0, 32000.0},   // MMIN
+    {8.92, 1.03, 0.95, 0.0, 64.0, 64000.0},   // MMAX
+    {3.01, 1.16, 0.62, 0.33, 1.0, 256.0},     // CACH
+    {0.97, 1.04, 0.49, 0.024, 1.0, 52.0},     // CHMIN
+    {2.32, 1.11, 0.51, 0.024, 1.0, 176.0},    // CHMAX
+};
+
+// Least squares ERP weights on machine.data (no intercept).
+const double kErpWeights[MachineData::kNumFeatures] = {-0.0340, 0.01539, 0.003992, 0.4411, -1.1199, 1.5553};
+const double kPrpNoise = 0.3; // sd of log(PRP / ERP)
+
+struct VendorShare
+{
+    const char* name;
+    int rows;
+};
+
+const VendorShare kVendors[] = {
+    {"adviser", 1}, {"amdahl", 9}, {"apollo", 2}, {"basf", 2}, {"bti", 2}, {"burroughs", 8},
+    {"c.r.d", 6}, {"cambex", 5}, {"cdc", 9}, {"dec", 6}, {"dg", 7}, {"formation", 5},
+    {"four-phase", 1}, {"gould", 3}, {"harris", 7}, {"honeywell", 13}, {"hp", 7}, {"ibm", 32},
+    {"ipl", 6}, {"magnuson", 6}, {"microdata", 1}, {"nas", 19}, {"ncr", 13}, {"nixdorf", 3},
+    {"perkin-elmer", 3}, {"prime", 5}, {"siemens", 12}, {"sperry", 13}, {"sratus", 1}, {"wang", 2},
+};
+const int kVendorRows = 209; // sum of the shares
+
+// Uniform in (0, 1] from the top 53 bits.
+double unit(uint64_t bits) {
+    return static_cast<double>((bits >> 11) + 1) * 0x1.0p-53;
+}
+
+char* write_int(char* out, double value) {
+    return to_chars(out, out + 24, static_cast<long long>(value)).ptr;
+}
+
+}
+
+// SyntheticMachineData //
+void SyntheticMachineData::row(size_t index, SyntheticRow& out) const {
+    uint64_t bits[kDrawsPerRow];
+    for (int k = 0; k < kDrawsPerRow; ++k) bits[k] = CounterRng::at(mSeed, index * kDrawsPerRow + k);
+
+    // Eight standard normals by Box-Muller: the size factor, one idiosyncratic
+    // term per predictor and the PRP noise.
+    double normal[8];
+    for (int k = 0; k < 8; k += 2) {
+        double r = sqrt(-2.0 * log(unit(bits[k])));
+        double theta = kTwoPi * unit(bits[k + 1]);
+        normal[k] = r * cos(theta);
+        normal[k + 1] = r * sin(theta);
+    }
+    const double size = normal[0];
+    const bool noCache = unit(bits[8]) <= kShapes[3].zeroFraction;
+    const bool noChannels = unit(bits[9]) <= kShapes[4].zeroFraction;
+
+    for (int j = 0; j < MachineData::kNumFeatures; ++j) {
+        const FeatureShape& s = kShapes[j];
+        double z = s.loading * size + sqrt(1.0 - s.loading * s.loading) * normal[j + 1];
+        out.features[j] = clamp(round(exp(s.logMean + s.logSd * z)), s.min, s.max);
+    }
+    if (noCache) out.features[3] = 0.0;
+    if (noChannels) out.features[4] = out.features[5] = 0.0;
+    out.features[2] = max(out.features[2], out.features[1]); // MMAX >= MMIN
+    out.features[5] = max(out.features[5], out.features[4]); // CHMAX >= CHMIN
+
+    double erp = 0.0;
+    for (int j = 0; j < MachineData::kNumFeatures; ++j) erp += kErpWeights[j] * out.features[j];
+    out.erp = max(15.0, round(erp));
+    out.prp = max(6.0, round(out.erp * exp(kPrpNoise * normal[7])));
+
+    int pick = static_cast<int>((bits[10] >> 32) * kVendorRows >> 32);
+    out.vendor = 0;
+    while (pick >= kVendors[out.vendor].rows) pick -= kVendors[out.vendor++].rows;
+}
+
+const vector<string>& SyntheticMachineData::vendorNames() {
+    static const vector<string> names = [] {
+        vector<string> list;
+        for (const VendorShare& v : kVendors) list.push_back(v.name);
+        return list;
+    }();
+    return names;
+}
+
+void write_synthetic_csv(const string& path, size_t numRows, uint64_t seed, unsigned numThreads) {
+    const SyntheticMachineData generator(seed);
+    const vector<string>& vendors = SyntheticMachineData::vendorNames();
+    // The reader always skips the first line, so the rows follow a header.
+    string header = "vendor,model";
+    for (int j = 0; j < MachineData::kNumFeatures + 2; ++j) header += string(",") + MachineData::kColumnNames[j];
+    header += '\n';
+    {
+        ofstream create(path, ios::binary | ios::trunc);
+        create.write(header.data(), header.size());
+        if (!create)
+            throw runtime_error("Could not create file: " + path);
+    }
+
+    const size_t numBlocks = (numRows + kCsvBlockRows - 1) / kCsvBlockRows;
+    const unsigned workers = worker_count(numBlocks, numThreads);
+    vector<vector<char>> buffers(workers, vector<char>(min(kCsvBlockRows, numRows) * kMaxLineBytes));
+    vector<size_t> lengths(workers);
+
+    // A round formats up to one block per worker, then writes the blocks at
+    // offsets given by the running total of the formatted lengths.
+    uint64_t offset = header.size();
+    for (size_t first = 0; first < numBlocks; first += workers) {
+        const unsigned count = static_cast<unsigned>(min<size_t>(workers, numBlocks - first));
+        parallel_for(count, count, [&](size_t b) {
+            size_t begin = (first + b) * kCsvBlockRows;
+            size_t end = min(numRows, begin + kCsvBlockRows);
+            char* out = buffers[b].data();
+            SyntheticRow row;
+            for (size_t i = begin; i < end; ++i) {
+                generator.row(i, row);
+                const string& vendor = vendors[row.vendor];
+                out = copy(vendor.begin(), vendor.end(), out);
+                out = copy_n(",syn", 4, out);
+                out = to_chars(out, out + 24, i).ptr;
+                for (int j = 0; j < MachineData::kNumFeatures; ++j) {
+                    *out++ = ',';
+                    out = write_int(out, row.features[j]);
+                }
+                *out++ = ',';
+                out = write_int(out, row.prp);
+                *out++ = ',';
+                out = write_int(out, row.erp);
+                *out++ = '\n';
+            }
+            lengths[b] = out - buffers[b].data();
+        });
+        vector<uint64_t> offsets(count);
+        for (unsigned b = 0; b < count; ++b) {
+            offsets[b] = offset;
+            offset += lengths[b];
+        }
+        parallel_for(count, count, [&](size_t b) {
+            fstream out(path, ios::binary | ios::in | ios::out);
+            out.seekp(offsets[b]);
+            out.write(buffers[b].data(), lengths[b]);
+            if (!out)
+                throw runtime_error("Could not write file: " + path);
+        });
+    }
+}
+
+void write_synthetic_cache(const string& path, size_t numRows, uint64_t seed, unsigned numThreads) {
+    const SyntheticMachineData generator(seed);
+    vector<string> names(MachineData::kColumnNames, MachineData::kColumnNames + MachineData::kNumFeatures + 2);
+    names.push_back("VENDOR");
+
+    write_dataset_cache(path, numRows, names, SyntheticMachineData::vendorNames(),
+                        [&](size_t begin, size_t end, double* const* columns) {
+        SyntheticRow row;
+        for (size_t i = begin; i < end; ++i) {
+            generator.row(i, row);
+            for (int j = 0; j < MachineData::kNumFeatures; ++j) columns[j][i - begin] = row.features[j];
+            columns[MachineData::kNumFeatures][i - begin] = row.prp;
+            columns[MachineData::kNumFeatures + 1][i - begin] = row.erp;
+            columns[MachineData::kNumFeatures + 2][i - begin] = row.vendor;
+        }
+    }, numThreads);
+}
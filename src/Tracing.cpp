@@ -0,0 +1,214 @@
+#include "../include/Tracing.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const uint64_t kRingMask = kTraceRingEvents - 1;
+static_assert((kTraceRingEvents & kRingMask) == 0, "ring size must be a power of two");
+
+// Slots are atomics so that a collector reading a slot the owner is reusing
+// sees a stale or a new value, never a torn one; the counters below tell it
+// which slots to throw away.
+struct Slot
+{
+    atomic<const char*> name;
+    atomic<int64_t> begin;
+    atomic<int64_t> end;
+};
+
+struct Event
+{
+    const char* name;
+    int64_t begin;
+    int64_t end;
+    uint32_t tid;
+};
+
+// Single producer: only the owning thread writes the slots and both counters.
+// Event i lives in slot i & kRingMask. claimed is raised before a slot is
+// written and written after it, so every event below written is complete and
+// event i is intact as long as claimed <= i + kTraceRingEvents.
+struct Ring
+{
+    unique_ptr<Slot[]> slots;
+    atomic<uint64_t> claimed;
+    atomic<uint64_t> written;
+    uint64_t base = 0; // first event since the last reset; guarded by the registry lock
+    uint32_t tid;
+
+    explicit Ring(uint32_t id): slots(new Slot[kTraceRingEvents]), claimed(0), written(0), tid(id) {}
+
+    void record(const char* name, int64_t begin, int64_t end) {
+        uint64_t i = written.load(memory_order_relaxed);
+        claimed.store(i + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        Slot& slot = slots[i & kRingMask];
+        slot.name.store(name, memory_order_relaxed);
+        slot.begin.store(begin, memory_order_relaxed);
+        slot.end.store(end, memory_order_relaxed);
+        written.store(i + 1, memory_order_release);
+    }
+
+    // Appends the intact events since base; returns how many were lost.
+    uint64_t collect(vector<Event>& events) const {
+        uint64_t last = written.load(memory_order_acquire);
+        uint64_t first = max(base, last > kTraceRingEvents ? last - kTraceRingEvents : 0);
+        size_t start = events.size();
+        for (uint64_t i = first; i < last; ++i) {
+            const Slot& slot = slots[i & kRingMask];
+            events.push_back({slot.name.load(memory_order_relaxed), slot.begin.load(memory_order_relaxed),
+                              slot.end.load(memory_order_relaxed), tid});
+        }
+        // Drop whatever the owner may have overwritten while we were copying.
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t reused = claimed.load(memory_order_relaxed);
+        uint64_t intact = reused > kTraceRingEvents ? reused - kTraceRingEvents : 0;
+        if (intact > first) {
+            size_t lost = static_cast<size_t>(min(intact, last) - first);
+            events.erase(events.begin() + start, events.begin() + start + lost);
+            first += lost;
+        }
+        return first - base;
+    }
+};
+
+struct Registry
+{
+    mutex lock;
+    vector<Ring*> live;
+    vector<Event> retired;     // events of threads that have exited
+    uint64_t retiredDropped = 0;
+    uint32_t nextTid = 1;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+struct ThreadState
+{
+    unique_ptr<Ring> ring;
+
+    ThreadState() {
+        Registry& r = registry();
+        lock_guard<mutex> guard(r.lock);
+        ring.reset(new Ring(r.nextTid++));
+        r.live.push_back(ring.get());
+    }
+
+    ~ThreadState() {
+        Registry& r = registry();
+        lock_guard<mutex> guard(r.lock);
+        r.retiredDropped += ring->collect(r.retired);
+        r.live.erase(find(r.live.begin(), r.live.end(), ring.get()));
+    }
+};
+
+Ring& thread_ring() {
+    thread_local ThreadState state;
+    return *state.ring;
+}
+
+int64_t now_ns() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+vector<Event> collect_events(uint64_t& dropped) {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    vector<Event> events = r.retired;
+    dropped = r.retiredDropped;
+    for (Ring* ring : r.live) dropped += ring->collect(events);
+    return events;
+}
+
+void write_json_string(ostream& out, const char* s) {
+    out << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out << '\\';
+        out << *s;
+    }
+    out << '"';
+}
+
+}
+
+// ScopedTraceEvent //
+// Constructor and destructor
+ScopedTraceEvent::ScopedTraceEvent(const char* name): mName(name) {
+    thread_ring();
+    mBegin = now_ns();
+}
+
+ScopedTraceEvent::~ScopedTraceEvent() {
+    thread_ring().record(mName, mBegin, now_ns());
+}
+
+// Export
+size_t write_chrome_trace(ostream& out) {
+    uint64_t dropped;
+    vector<Event> events = collect_events(dropped);
+    sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+        return a.begin != b.begin ? a.begin < b.begin : a.end > b.end;
+    });
+    vector<uint32_t> tids;
+    for (const Event& e : events) tids.push_back(e.tid);
+    sort(tids.begin(), tids.end());
+    tids.erase(unique(tids.begin(), tids.end()), tids.end());
+
+    // Timestamps are microseconds from the first event.
+    const int64_t origin = events.empty() ? 0 : events.front().begin;
+    char number[64];
+    out << "{\"traceEvents\": [\n";
+    for (size_t i = 0; i < tids.size(); ++i) {
+        out << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << tids[i]
+            << ", \"args\": {\"name\": \"thread " << tids[i] << "\"}}"
+            << (i + 1 < tids.size() || !events.empty() ? "," : "") << "\n";
+    }
+    for (size_t i = 0; i < events.size(); ++i) {
+        const Event& e = events[i];
+        out << "  {\"name\": ";
+        write_json_string(out, e.name);
+        snprintf(number, sizeof(number), "%.3f", (e.begin - origin) / 1e3);
+        out << ", \"cat\": \"tinyProject\", \"ph\": \"X\", \"ts\": " << number;
+        snprintf(number, sizeof(number), "%.3f", (e.end - e.begin) / 1e3);
+        out << ", \"dur\": " << number << ", \"pid\": 1, \"tid\": " << e.tid << "}"
+            << (i + 1 < events.size() ? "," : "") << "\n";
+    }
+    out << "], \"displayTimeUnit\": \"ns\", \"otherData\": {\"droppedEvents\": " << dropped << "}}\n";
+    return events.size();
+}
+
+size_t write_chrome_trace(const string& path) {
+    ofstream out(path);
+    size_t count = write_chrome_trace(out);
+    if (!out)
+        throw runtime_error("Could not write file: " + path);
+    return count;
+}
+
+uint64_t trace_dropped_events() {
+    uint64_t dropped;
+    collect_events(dropped);
+    return dropped;
+}
+
+void trace_reset() {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    for (Ring* ring : r.live) ring->base = ring->written.load(memory_order_acquire);
+    r.retired.clear();
+    r.retiredDropped = 0;
+}
@@ -1,16 +1,19 @@
 #include "../include/Vector.h"
+#include "../include/Instrumentation.h"
 #include <iostream>
 
 using namespace std;
 
 // Constructor and destructor
 Vector::Vector(int size): mSize(size), mData(new double[mSize]) {
+    TP_INSTRUMENT_ALLOCATIONS(1, mSize * sizeof(double));
     for (int i = 0; i < mSize; i++) {
         mData[i] = 0.0;
     }
 }
 
 Vector::Vector(const Vector& other): mSize(other.mSize), mData(new double[mSize]) {
+    TP_INSTRUMENT_ALLOCATIONS(1, mSize * sizeof(double));
     for (int i = 0; i < mSize; i++) {
         mData[i] = other.mData[i];
     }
@@ -18,11 +21,13 @@ Vector::Vector(const Vector& other): mSize(other.mSize), mData(new double[mSize]
 
 // Assignment operator
 Vector& Vector::operator=(const Vector& other) {
+    TP_INSTRUMENT_OP(VectorAssign, 0, 16.0 * other.mSize);
     if (this != &other)
     {
         // delete[] mData;
         mSize = other.mSize;
         mData = new double[mSize];
+        TP_INSTRUMENT_ALLOCATIONS(1, mSize * sizeof(double));
         for (int i = 0; i < mSize; i++) {
             mData[i] = other.mData[i];
         }
@@ -32,10 +37,12 @@ Vector& Vector::operator=(const Vector& other) {
 
 //Unary operators
 Vector Vector::operator+() const{
+    TP_INSTRUMENT_OP(VectorUnary, 0, 16.0 * mSize);
     return *this;
 }
 
 Vector Vector::operator-() const{
+    TP_INSTRUMENT_OP(VectorUnary, mSize, 16.0 * mSize);
     Vector result(mSize);
     for (int i = 0; i < mSize; i++) {
         result.mData[i] = -mData[i];
@@ -46,6 +53,7 @@ Vector Vector::operator-() const{
 // Binary operators
 
 Vector Vector::operator+ (Vector const& other) const {
+    TP_INSTRUMENT_OP(VectorAdd, mSize, 24.0 * mSize);
     if (mSize != other.mSize)
         throw runtime_error("Vector sizes do not match for addition.");
     Vector result(mSize);
@@ -56,6 +64,7 @@ Vector Vector::operator+ (Vector const& other) const {
 }
 
 Vector Vector::operator- (Vector const& other) const {
+    TP_INSTRUMENT_OP(VectorSubtract, mSize, 24.0 * mSize);
     if (mSize != other.mSize)
         throw runtime_error("Vector sizes do not match for addition.");
     Vector result(mSize);
@@ -67,6 +76,7 @@ Vector Vector::operator- (Vector const& other) const {
 
 // Dot product
 double Vector::operator* (Vector const& other) const {
+    TP_INSTRUMENT_OP(VectorDot, 2.0 * mSize, 16.0 * mSize);
     if (mSize != other.mSize)
         throw runtime_error("Vector sizes do not match for addition.");
     double sum = 0.0;
@@ -78,6 +88,7 @@ double Vector::operator* (Vector const& other) const {
 
 // Scalar multiplication
 Vector Vector::operator* (double scalar) const {
+    TP_INSTRUMENT_OP(VectorScale, mSize, 16.0 * mSize);
     Vector result(mSize);
     for(int i = 0; i < mSize; i++) {
         result[i] = mData[i] * scalar;
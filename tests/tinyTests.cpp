@@ -0,0 +1,703 @@
+#include "../include/BitPacking.h"
+#include "../include/Bootstrap.h"
+#include "../include/Cholesky.h"
+#include "../include/CrossValidation.h"
+#include "../include/DatasetCache.h"
+#include "../include/DatasetSplit.h"
+#include "../include/ElasticNet.h"
+#include "../include/Evaluation.h"
+#include "../include/FeatureExpansion.h"
+#include "../include/KNearestNeighbours.h"
+#include "../include/MachineData.h"
+#include "../include/Model.h"
+#include "../include/NormalEquations.h"
+#include "../include/OneHotRegression.h"
+#include "../include/Regression.h"
+#include "../include/RidgeRegression.h"
+#include "../include/ScoringEngine.h"
+#include "../include/SyntheticData.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Behavioural tests of the numerical code against reference computations:
+// closed forms and shortcuts are checked against the direct fits they
+// replace. Run from the build directory, where data/machine.data is copied.
+//
+//     tinyTests [name filter]
+
+namespace {
+
+const int p = MachineData::kNumFeatures;
+
+void check(bool condition, const string& what) {
+    if (!condition) throw runtime_error(what);
+}
+
+// |actual - expected| <= tolerance * max(1, |expected|)
+void check_close(double actual, double expected, double tolerance, const string& what) {
+    if (!(fabs(actual - expected) <= tolerance * max(1.0, fabs(expected)))) {
+        ostringstream message;
+        message.precision(17);
+        message << what << ": got " << actual << ", expected " << expected;
+        throw runtime_error(message.str());
+    }
+}
+
+MachineData machine_data() {
+    return read_machine_data("data/machine.data");
+}
+
+MachineData synthetic_data(size_t rows, uint64_t seed) {
+    SyntheticMachineData generator(seed);
+    MachineData data;
+    SyntheticRow row;
+    for (size_t i = 0; i < rows; ++i) {
+        generator.row(i, row);
+        data.features.insert(data.features.end(), row.features, row.features + p);
+        data.targets.push_back(row.prp);
+        data.erp.push_back(row.erp);
+        data.vendors.push_back(row.vendor);
+    }
+    data.vendorNames = SyntheticMachineData::vendorNames();
+    return data;
+}
+
+// Direct least squares fit of the rows for which keep(i) is true.
+template <typename Keep>
+Vector direct_fit(const MachineData& data, Keep keep) {
+    NormalEquationsAccumulator normal(p);
+    for (size_t i = 0; i < data.rows(); ++i) {
+        if (keep(i)) normal.addRow(data.row(i), data.targets[i]);
+    }
+    return normal.solve();
+}
+
+double dot(const double* x, const Vector& w) {
+    double sum = 0.0;
+    for (int j = 0; j < w.size(); ++j) sum += x[j] * w[j];
+    return sum;
+}
+
+// Random symmetric positive definite matrix MᵀM + I, row-major n x n.
+vector<double> random_spd(int n, mt19937_64& rng) {
+    uniform_real_distribution<double> u(-1.0, 1.0);
+    vector<double> M(static_cast<size_t>(n + 3) * n), A(static_cast<size_t>(n) * n);
+    for (double& m : M) m = u(rng);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            double sum = i == j ? 1.0 : 0.0;
+            for (int k = 0; k < n + 3; ++k) sum += M[k * n + i] * M[k * n + j];
+            A[i * n + j] = sum;
+        }
+    }
+    return A;
+}
+
+void check_factor(const Cholesky& actual, const Cholesky& expected, const string& what) {
+    const int n = expected.size();
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            check_close(actual.factor()[i * n + j], expected.factor()[i * n + j], 1e-10, what);
+        }
+    }
+}
+
+// Tests //
+void test_cholesky_modifications() {
+    const int n = 7;
+    mt19937_64 rng(1);
+    uniform_real_distribution<double> u(-1.0, 1.0);
+    vector<double> A = random_spd(n, rng), x(n);
+    for (double& v : x) v = u(rng);
+
+    vector<double> Aplus = A;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) Aplus[i * n + j] += x[i] * x[j];
+    }
+
+    Cholesky chol(A.data(), n);
+    chol.update(x.data());
+    check_factor(chol, Cholesky(Aplus.data(), n), "update");
+    chol.downdate(x.data());
+    check_factor(chol, Cholesky(A.data(), n), "downdate");
+
+    vector<double> scaled = A;
+    for (double& v : scaled) v *= 2.5;
+    chol.scale(2.5);
+    check_factor(chol, Cholesky(scaled.data(), n), "scale");
+
+    // Removing more than the matrix holds must be refused.
+    vector<double> big(n, 0.0);
+    big[0] = 10.0 * sqrt(scaled[0]);
+    bool threw = false;
+    try {
+        chol.downdate(big.data());
+    } catch (const runtime_error&) {
+        threw = true;
+    }
+    check(threw, "downdate past definiteness did not throw");
+}
+
+void test_cholesky_multiple_rhs() {
+    const int n = 9, m = 4;
+    mt19937_64 rng(2);
+    uniform_real_distribution<double> u(-1.0, 1.0);
+    vector<double> A = random_spd(n, rng), B(static_cast<size_t>(n) * m);
+    for (double& v : B) v = u(rng);
+
+    Cholesky chol(A.data(), n);
+    vector<double> X = B;
+    chol.solveInPlace(X.data(), m);
+    for (int r = 0; r < m; ++r) {
+        Vector b(n);
+        for (int i = 0; i < n; ++i) b[i] = B[i * m + r];
+        Vector x = chol.Solve(b);
+        for (int i = 0; i < n; ++i) check_close(X[i * m + r], x[i], 1e-12, "multi-RHS column");
+        // and x really solves A x = b
+        for (int i = 0; i < n; ++i) {
+            double Ax = 0.0;
+            for (int j = 0; j < n; ++j) Ax += A[i * n + j] * x[j];
+            check_close(Ax, b[i], 1e-10, "A x = b");
+        }
+    }
+}
+
+void test_bit_packing_round_trip() {
+    mt19937_64 rng(3);
+    for (int width = 0; width <= 32; ++width) {
+        // Sizes around block boundaries, including a partial last block.
+        for (size_t count : {size_t(1), kBitPackBlock - 1, kBitPackBlock, 3 * kBitPackBlock + 17}) {
+            uint64_t mask = width == 0 ? 0 : (width == 32 ? 0xFFFFFFFFULL : (uint64_t(1) << width) - 1);
+            vector<double> values(count);
+            for (double& v : values) v = -1000.0 + static_cast<double>(rng() & mask);
+            values[0] = -1000.0; // pin the reference
+
+            int64_t reference;
+            int bitWidth;
+            check(bitpack_plan(values.data(), count, reference, bitWidth), "integers rejected by bitpack_plan");
+            check(bitWidth <= width, "bit width larger than the range needs");
+            vector<uint32_t> words(bitpack_words(count, bitWidth));
+            bitpack_encode(values.data(), count, reference, bitWidth, words.data());
+
+            vector<double> decoded(bitpack_blocks(count) * kBitPackBlock);
+            bitpack_decode(words.data(), reference, bitWidth, 0, bitpack_blocks(count), decoded.data());
+            for (size_t i = 0; i < count; ++i) {
+                check(decoded[i] == values[i], "bitpack_decode at width " + to_string(width));
+                check(bitpack_get(words.data(), reference, bitWidth, i) == values[i],
+                      "bitpack_get at width " + to_string(width));
+            }
+        }
+    }
+    double fractional = 0.5;
+    int64_t reference;
+    int bitWidth;
+    check(!bitpack_plan(&fractional, 1, reference, bitWidth), "non-integer accepted by bitpack_plan");
+}
+
+void test_dataset_cache_blocks() {
+    MachineData data = synthetic_data(1000, 7);
+    string path = (filesystem::temp_directory_path() / "tinyTests.tpcache").string();
+    write_dataset_cache(path, data, SourceStamp{0, 0, 0});
+    {
+        DatasetCache cache(path);
+        check(cache.rows() == data.rows(), "cached row count");
+        vector<double> buffer(kColumnBlockRows);
+        for (int j = 0; j <= p; ++j) {
+            const ColumnView& column = cache.column(j);
+            check(column.packed, string("integer column not packed: ") + column.name);
+            for (size_t b = 0; b < column.numBlocks(); ++b) {
+                const double* values = column.block(b, buffer.data());
+                for (size_t r = 0; r < kColumnBlockRows && b * kColumnBlockRows + r < data.rows(); ++r) {
+                    size_t i = b * kColumnBlockRows + r;
+                    double expected = j < p ? data.row(i)[j] : data.targets[i];
+                    check(values[r] == expected && column[i] == expected, string("cached value of ") + column.name);
+                }
+            }
+        }
+
+        // Block-pulling Gram and evaluation against the in-memory rows.
+        NormalEquationsAccumulator cached = accumulate_dataset_cache(cache, 3);
+        NormalEquationsAccumulator direct(p);
+        direct.addRows(data.row(0), data.targets.data(), data.rows());
+        Vector wc = cached.solve(), wd = direct.solve();
+        for (int j = 0; j < p; ++j) check_close(wc[j], wd[j], 1e-8, "weights from the cache");
+
+        vector<string> names(MachineData::kColumnNames, MachineData::kColumnNames + p);
+        Model model(names, wd);
+        RegressionMetrics fromCache = evaluate_regression(cache, model, 3);
+        RegressionMetrics fromRows = evaluate_regression(data, model, 1);
+        check(fromCache.count == fromRows.count, "evaluated row count");
+        check_close(fromCache.rmse, fromRows.rmse, 1e-12, "RMSE from the cache");
+        check_close(fromCache.maxError, fromRows.maxError, 1e-12, "max error from the cache");
+    }
+
+    // Header fields whose offset + size would wrap around must be refused.
+    string bytes;
+    {
+        ifstream in(path, ios::binary);
+        bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    uint64_t dictionaryOffset;
+    memcpy(&dictionaryOffset, &bytes[48], sizeof(dictionaryOffset));
+    check(dictionaryOffset != 0, "vendor dictionary not written");
+    struct Corruption
+    {
+        size_t at;
+        uint64_t value;
+        const char* what;
+    };
+    const Corruption corruptions[] = {
+        {16, uint64_t(1) << 61, "row count"},               // numRows * 8 wraps to 0
+        {80, ~uint64_t(63), "column offset"},               // offset + bytes wraps
+        {56, 1 - dictionaryOffset, "vendor dictionary size"} // offset + size wraps to 1
+    };
+    for (const Corruption& corruption : corruptions) {
+        string corrupt = bytes;
+        memcpy(&corrupt[corruption.at], &corruption.value, sizeof(corruption.value));
+        {
+            ofstream out(path, ios::binary | ios::trunc);
+            out << corrupt;
+        }
+        bool threw = false;
+        try {
+            DatasetCache cache(path);
+        } catch (const runtime_error&) {
+            threw = true;
+        }
+        check(threw, string("corrupt ") + corruption.what + " accepted");
+    }
+    filesystem::remove(path);
+}
+
+void test_leave_one_out() {
+    MachineData data = machine_data();
+    LeaveOneOutResult loo = leave_one_out(data, 2);
+    double press = 0.0;
+    for (size_t k = 0; k < data.rows(); ++k) {
+        Vector w = direct_fit(data, [k](size_t i) {return i != k;});
+        double residual = data.targets[k] - dot(data.row(k), w);
+        check_close(loo.residuals[k], residual, 1e-6, "LOO residual of row " + to_string(k));
+        press += residual * residual;
+    }
+    check_close(loo.rmse, sqrt(press / data.rows()), 1e-8, "LOO RMSE");
+
+    // Column 5 is zero except in rows 0 and 1: row 0's leverage is within
+    // 1e-8 of 1, so its residual comes from a downdate refit.
+    for (size_t i = 0; i < data.rows(); ++i) data.features[i * p + 5] = 0.0;
+    data.features[5] = 1000.0;
+    data.features[p + 5] = 0.05;
+    loo = leave_one_out(data, 2);
+    check(1.0 - loo.leverage[0] < 1e-8, "row 0 does not have leverage next to 1");
+    Vector w = direct_fit(data, [](size_t i) {return i != 0;});
+    check_close(loo.residuals[0], data.targets[0] - dot(data.row(0), w), 1e-5, "LOO residual at leverage 1 - 1e-9");
+    check(isfinite(loo.rmse), "LOO RMSE not finite");
+
+    // With row 1 zeroed too, row 0 alone determines w₅.
+    data.features[p + 5] = 0.0;
+    bool threw = false;
+    try {
+        leave_one_out(data, 2);
+    } catch (const runtime_error&) {
+        threw = true;
+    }
+    check(threw, "leverage 1 did not throw");
+}
+
+void test_k_fold() {
+    MachineData data = machine_data();
+    const int k = 5;
+    CrossValidationResult cv = k_fold_cross_validation(data, k, 11, 3);
+    vector<int> fold = assign_folds(data.rows(), k, 11);
+    double pooled = 0.0;
+    for (int f = 0; f < k; ++f) {
+        Vector w = direct_fit(data, [&fold, f](size_t i) {return fold[i] != f;});
+        double sse = 0.0;
+        size_t rows = 0;
+        for (size_t i = 0; i < data.rows(); ++i) {
+            if (fold[i] != f) continue;
+            double e = data.targets[i] - dot(data.row(i), w);
+            sse += e * e;
+            ++rows;
+        }
+        check(cv.foldRows[f] == rows, "fold size");
+        check_close(cv.foldRmse[f], sqrt(sse / rows), 1e-6, "RMSE of fold " + to_string(f));
+        pooled += sse;
+    }
+    check_close(cv.rmse, sqrt(pooled / data.rows()), 1e-6, "pooled k-fold RMSE");
+}
+
+void test_ridge_path() {
+    MachineData data = machine_data();
+    vector<int> fold = assign_folds(data.rows(), 5, 3);
+    NormalEquationsAccumulator train(p), validation(p);
+    for (size_t i = 0; i < data.rows(); ++i) {
+        (fold[i] == 0 ? validation : train).addRow(data.row(i), data.targets[i]);
+    }
+    vector<double> lambdas = {0.0, 1e-3, 0.5, 10.0, 1e4};
+    RidgePath path = ridge_path(train, validation, lambdas, 2);
+
+    // The path penalises unit-RMS columns, i.e. solves (G + λ diag(G_jj / n)) w = Xᵀy.
+    Matrix G = train.gram();
+    Vector Xty = train.xty();
+    for (size_t k = 0; k < lambdas.size(); ++k) {
+        vector<double> A(static_cast<size_t>(p) * p);
+        for (int i = 0; i < p; ++i) {
+            for (int j = 0; j < p; ++j) A[i * p + j] = G[i][j];
+            A[i * p + i] += lambdas[k] * G[i][i] / train.nRows();
+        }
+        Vector w = Cholesky(A.data(), p).Solve(Xty);
+        for (int j = 0; j < p; ++j) check_close(path.weights[k][j], w[j], 1e-7, "ridge weight");
+
+        double sse = 0.0;
+        for (size_t i = 0; i < data.rows(); ++i) {
+            if (fold[i] != 0) continue;
+            double e = data.targets[i] - dot(data.row(i), w);
+            sse += e * e;
+        }
+        check_close(path.validationRmse[k], sqrt(sse / validation.nRows()), 1e-6, "ridge validation RMSE");
+    }
+
+    bool threw = false;
+    try {
+        ridge_path(train, validation, vector<double>());
+    } catch (const runtime_error&) {
+        threw = true;
+    }
+    check(threw, "empty penalty list did not throw");
+}
+
+void check_elastic_net_kkt(const MachineData& data, const string& what) {
+    NormalEquationsAccumulator train(p);
+    train.addRows(data.row(0), data.targets.data(), data.rows());
+    Matrix G = train.gram();
+    Vector Xty = train.xty();
+    const double n = static_cast<double>(train.nRows());
+
+    // A coarse path makes the strong rule keep every feature after the first
+    // step (2λ < λ_prev), zero columns included.
+    for (int numLambdas : {20, 3})
+    for (double alpha : {1.0, 0.5}) {
+        ElasticNetOptions options;
+        options.alpha = alpha;
+        options.numLambdas = numLambdas;
+        options.minRatio = 1e-3;
+        ElasticNetPath path = elastic_net_path(train, options);
+
+        // KKT conditions of |y - Xw|²/2n + λ(α|v|₁ + (1-α)|v|²/2) on unit-RMS
+        // columns (RMS s_j, v_j = s_j w_j): with g_j = (Xᵀy - Gw)_j / (n s_j),
+        // an active v_j has g_j - λ(1-α)v_j = λα sign(v_j) and an inactive one
+        // |g_j| <= λα. An all-zero column has no condition and must stay zero.
+        vector<double> s(p);
+        for (int j = 0; j < p; ++j) s[j] = sqrt(G[j][j] / n);
+        for (size_t k = 0; k < path.lambdas.size(); ++k) {
+            const double l1 = path.lambdas[k] * alpha, l2 = path.lambdas[k] * (1.0 - alpha);
+            const double tolerance = 1e-4 * max(l1, 1e-3);
+            int nonZeros = 0;
+            for (int j = 0; j < p; ++j) {
+                check(isfinite(path.weights[k][j]), what + ": non-finite weight");
+                if (s[j] == 0.0) {
+                    check(path.weights[k][j] == 0.0, what + ": weight of an all-zero column");
+                    continue;
+                }
+                double g = Xty[j] / n;
+                for (int i = 0; i < p; ++i) g -= G[j][i] * path.weights[k][i] / n;
+                g /= s[j];
+                double v = path.weights[k][j] * s[j];
+                if (v != 0.0) {
+                    ++nonZeros;
+                    check_close(g - l2 * v, v > 0.0 ? l1 : -l1, tolerance, what + ": KKT of an active weight");
+                } else {
+                    check(fabs(g) <= l1 + tolerance, what + ": KKT of an inactive weight");
+                }
+            }
+            check(nonZeros == path.nonZeros[k], what + ": non-zero count");
+        }
+    }
+}
+
+void test_elastic_net_kkt() {
+    MachineData data = machine_data();
+    check_elastic_net_kkt(data, "machine data");
+
+    // A coordinate without curvature: lasso steps on it would divide 0 by 0.
+    for (size_t i = 0; i < data.rows(); ++i) data.features[i * p + 1] = 0.0;
+    check_elastic_net_kkt(data, "all-zero column");
+}
+
+void test_multi_target_solve() {
+    MachineData data = machine_data();
+    Matrix X(data.rows(), p), Y(data.rows(), 2);
+    Vector prp(data.rows()), erp(data.rows());
+    for (size_t i = 0; i < data.rows(); ++i) {
+        copy(data.row(i), data.row(i) + p, X[i]);
+        Y[i][0] = prp[i] = data.targets[i];
+        Y[i][1] = erp[i] = data.erp[i];
+    }
+    Matrix W = solve_linear_regression(X, Y);
+    Vector wPrp = solve_linear_regression(X, prp), wErp = solve_linear_regression(X, erp);
+    for (int j = 0; j < p; ++j) {
+        check_close(W[j][0], wPrp[j], 1e-8, "PRP weight");
+        check_close(W[j][1], wErp[j], 1e-8, "ERP weight");
+    }
+}
+
+void test_one_hot_schur() {
+    MachineData data = machine_data();
+    // One more category than the vendors: it has no rows.
+    const int used = static_cast<int>(data.vendorNames.size()), m = used + 1;
+    OneHotNormalEquations onehot(p, m);
+    NormalEquationsAccumulator dense(p + used); // x followed by explicit indicators
+    vector<double> row(p + used);
+    for (size_t i = 0; i < data.rows(); ++i) {
+        onehot.addRow(data.row(i), data.vendors[i], data.targets[i]);
+        fill(row.begin(), row.end(), 0.0);
+        copy(data.row(i), data.row(i) + p, row.begin());
+        row[p + data.vendors[i]] = 1.0;
+        dense.addRow(row.data(), data.targets[i]);
+    }
+    OneHotFit fit = onehot.solve();
+    Vector w = dense.solve();
+
+    for (int j = 0; j < p; ++j) check_close(fit.weights[j], w[j], 1e-8, "numeric weight");
+    double weighted = 0.0;
+    vector<size_t> counts(m, 0);
+    for (int v : data.vendors) ++counts[v];
+    for (int v = 0; v < used; ++v) {
+        check_close(fit.offsets[v], w[p + v], 1e-8, "offset of vendor " + data.vendorNames[v]);
+        weighted += fit.offsets[v] * counts[v];
+    }
+    check_close(fit.meanOffset, weighted / data.rows(), 1e-10, "row-weighted mean offset");
+    check_close(fit.offsets[used], fit.meanOffset, 1e-12, "offset of a category without rows");
+    for (size_t i = 0; i < data.rows(); i += 17) {
+        double expected = w[p + data.vendors[i]];
+        for (int j = 0; j < p; ++j) expected += w[j] * data.row(i)[j];
+        check_close(fit.predict(data.row(i), data.vendors[i]), expected, 1e-8, "one-hot prediction");
+    }
+}
+
+void test_knn_kd_tree() {
+    MachineData reference = synthetic_data(3000, 21), queries = synthetic_data(100, 22);
+    // Reference rows as queries too: exact matches and ties.
+    queries.features.insert(queries.features.end(), reference.row(0), reference.row(0) + 50 * p);
+
+    // Brute force over every reference row gives each row's distance.
+    const size_t n = reference.rows();
+    KNearestNeighbours all(reference, static_cast<int>(n));
+    vector<size_t> allIndices(n);
+    vector<double> allDistances(n), distanceOf(n);
+
+    for (int k : {1, 7}) {
+        KNearestNeighbours knn(reference, k);
+        vector<size_t> indices(k);
+        vector<double> distances(k);
+        for (size_t q = 0; q < queries.features.size() / p; ++q) {
+            const double* x = &queries.features[q * p];
+            all.neighbours(x, allIndices.data(), allDistances.data(), KNearestNeighbours::Search::BruteForce);
+            for (size_t r = 0; r < n; ++r) distanceOf[allIndices[r]] = allDistances[r];
+
+            // Same k-th distances as the full ranking, and every neighbour
+            // returned really is that far away (ties may pick other rows).
+            knn.neighbours(x, indices.data(), distances.data(), KNearestNeighbours::Search::KdTree);
+            for (int r = 0; r < k; ++r) {
+                check(distances[r] == allDistances[r], "KD-tree distance of neighbour " + to_string(r));
+                check(distanceOf[indices[r]] == distances[r], "KD-tree neighbour at the wrong distance");
+            }
+            vector<size_t> unique(indices);
+            sort(unique.begin(), unique.end());
+            check(adjacent_find(unique.begin(), unique.end()) == unique.end(), "neighbour returned twice");
+        }
+    }
+}
+
+void test_feature_expansion() {
+    MachineData data = machine_data();
+    ExpansionOptions quadratic, cubicLogs;
+    cubicLogs.degree = 3;
+    cubicLogs.logFeatures = true;
+    cubicLogs.logTarget = true;
+    for (const ExpansionOptions& options : {quadratic, cubicLogs}) {
+        FeatureExpansion expansion(options, data);
+        const int terms = expansion.nTerms();
+        NormalEquationsAccumulator lazy = accumulate_expanded(expansion, data, 3);
+
+        // Reference: materialise every expanded row.
+        NormalEquationsAccumulator explicitRows(terms);
+        vector<double> row(terms);
+        for (size_t i = 0; i < data.rows(); ++i) {
+            expansion.expand(data.row(i), row.data());
+            explicitRows.addRow(row.data(), options.logTarget ? log1p(data.targets[i]) : data.targets[i]);
+        }
+        Matrix G = lazy.gram(), Gx = explicitRows.gram();
+        Vector b = lazy.xty(), bx = explicitRows.xty();
+        for (int i = 0; i < terms; ++i) {
+            check_close(b[i], bx[i], 1e-10, "expanded Xᵀy");
+            for (int j = 0; j < terms; ++j) check_close(G[i][j], Gx[i][j], 1e-10, "expanded XᵀX");
+        }
+        check(lazy.nRows() == data.rows(), "expanded row count");
+    }
+}
+
+void test_model_round_trip() {
+    vector<string> names(MachineData::kColumnNames, MachineData::kColumnNames + p);
+    vector<double> weights = {0.5, -1.25, 3.0, 1e-7, -2.0, 42.0};
+    vector<double> means = {10.0, 20.0, 30.0, 40.0, 50.0, 60.0};
+    vector<double> scales = {1.0, 2.0, 0.5, 4.0, 8.0, 0.25};
+    Model model(names, weights, means, scales, 7.5);
+
+    string path = (filesystem::temp_directory_path() / "tinyTests.tpmodel").string();
+    model.save(path);
+    Model loaded = Model::load(path);
+    filesystem::remove(path);
+
+    check(loaded.names() == model.names(), "names");
+    check(loaded.weights() == model.weights(), "weights");
+    check(loaded.means() == model.means(), "means");
+    check(loaded.scales() == model.scales(), "scales");
+    check(loaded.intercept() == model.intercept(), "intercept");
+    double x[p] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    double expected = 7.5;
+    for (int j = 0; j < p; ++j) expected += weights[j] * (x[j] - means[j]) / scales[j];
+    check_close(loaded.predict(x), expected, 1e-12, "prediction");
+    check_close(loaded.predictOne(x), expected, 1e-12, "predictOne");
+}
+
+void test_split_determinism() {
+    // CounterRng: a stream is a function of (seed, counter) and can be jumped.
+    CounterRng a(99), b(99), c(100);
+    vector<uint64_t> first;
+    for (int k = 0; k < 64; ++k) first.push_back(a());
+    for (int k = 0; k < 64; ++k) check(b() == first[k] && CounterRng::at(99, k) == first[k], "CounterRng stream");
+    CounterRng jumped(99, 40);
+    check(jumped() == first[40], "CounterRng jump");
+    check(c() != first[0], "different seeds give the same stream");
+
+    // Shuffles: permutations, reproducible, seed dependent.
+    const size_t n = 1000;
+    vector<uint32_t> order = shuffled_indices(n, 5);
+    check(order == shuffled_indices(n, 5), "shuffle not reproducible");
+    check(order != shuffled_indices(n, 6), "shuffle ignores the seed");
+    vector<uint32_t> sorted = order;
+    sort(sorted.begin(), sorted.end());
+    for (size_t i = 0; i < n; ++i) check(sorted[i] == i, "shuffle is not a permutation");
+
+    // Splits: train and test partition the rows; folds partition them too.
+    DatasetSplit split(n, 0.8, 5);
+    check(split.train().size() == 800 && split.test().size() == 200, "80/20 split sizes");
+    vector<int> seen(n, 0);
+    for (uint32_t i : split.train()) ++seen[i];
+    for (uint32_t i : split.test()) ++seen[i];
+    check(count(seen.begin(), seen.end(), 1) == static_cast<long>(n), "train and test do not partition the rows");
+    DatasetSplit again(n, 0.8, 5);
+    check(equal(split.all().begin(), split.all().end(), again.all().begin()), "split not reproducible");
+    fill(seen.begin(), seen.end(), 0);
+    for (int f = 0; f < 7; ++f) {
+        IndexView fold = split.fold(f, 7);
+        check(fold.size() == n * (f + 1) / 7 - n * f / 7, "fold size");
+        for (uint32_t i : fold) ++seen[i];
+    }
+    check(count(seen.begin(), seen.end(), 1) == static_cast<long>(n), "folds do not partition the rows");
+
+    // Fold labels name the same rows as the fold views.
+    vector<int> folds = assign_folds(n, 7, 5);
+    for (int f = 0; f < 7; ++f) {
+        for (uint32_t i : split.fold(f, 7)) check(folds[i] == f, "assign_folds disagrees with DatasetSplit::fold");
+    }
+}
+
+void test_bootstrap_determinism() {
+    MachineData data = machine_data();
+    BootstrapResult one = bootstrap_weights(data, 40, 0.9, 8, 1);
+    BootstrapResult many = bootstrap_weights(data, 40, 0.9, 8, 4);
+    check(one.weights == many.weights, "bootstrap depends on the thread count");
+    Vector w = direct_fit(data, [](size_t) {return true;});
+    for (int j = 0; j < p; ++j) {
+        check_close(one.estimate[j], w[j], 1e-10, "bootstrap estimate");
+        check(one.lower[j] <= one.upper[j], "interval bounds out of order");
+    }
+}
+
+void test_scoring_csv() {
+    vector<string> names(MachineData::kColumnNames, MachineData::kColumnNames + p);
+    Vector w(p);
+    for (int j = 0; j < p; ++j) w[j] = j + 1.0;
+    ScoringEngine engine(Model(names, w), 2);
+
+    // A blank line, a short line and a last line without a newline.
+    string path = (filesystem::temp_directory_path() / "tinyTests.csv").string();
+    {
+        ofstream out(path, ios::binary);
+        out << "1,1,1,1,1,1\n\n1,2\n1,0,0,0,0,2";
+    }
+    ostringstream scores;
+    size_t rows = engine.scoreFile(path, FeatureFormat::Csv, scores, true);
+    filesystem::remove(path);
+
+    check(rows == 4, "one prediction per line");
+    istringstream in(scores.str());
+    string line;
+    vector<string> lines;
+    while (getline(in, line)) lines.push_back(line);
+    check(lines.size() == 4, "predictions written");
+    check_close(stod(lines[0]), 21.0, 1e-12, "full line");
+    check(lines[1] == "nan" && lines[2] == "nan", "blank and short lines score as NaN");
+    check_close(stod(lines[3]), 13.0, 1e-12, "unterminated last line");
+}
+
+struct TestCase
+{
+    const char* name;
+    void (*run)();
+};
+
+const TestCase kTests[] = {
+    {"cholesky_modifications", test_cholesky_modifications},
+    {"cholesky_multiple_rhs", test_cholesky_multiple_rhs},
+    {"bit_packing_round_trip", test_bit_packing_round_trip},
+    {"dataset_cache_blocks", test_dataset_cache_blocks},
+    {"leave_one_out", test_leave_one_out},
+    {"k_fold", test_k_fold},
+    {"ridge_path", test_ridge_path},
+    {"elastic_net_kkt", test_elastic_net_kkt},
+    {"multi_target_solve", test_multi_target_solve},
+    {"one_hot_schur", test_one_hot_schur},
+    {"knn_kd_tree", test_knn_kd_tree},
+    {"feature_expansion", test_feature_expansion},
+    {"model_round_trip", test_model_round_trip},
+    {"split_determinism", test_split_determinism},
+    {"bootstrap_determinism", test_bootstrap_determinism},
+    {"scoring_csv", test_scoring_csv},
+};
+
+}
+
+int main(int argc, char* argv[])
+{
+    string filter = argc > 1 ? argv[1] : "";
+    int run = 0, failed = 0;
+    for (const TestCase& test : kTests) {
+        if (string(test.name).find(filter) == string::npos) continue;
+        ++run;
+        try {
+            test.run();
+            cout << "ok   " << test.name << endl;
+        } catch (const exception& e) {
+            ++failed;
+            cout << "FAIL " << test.name << ": " << e.what() << endl;
+        }
+    }
+    cout << run << " tests, " << failed << " failed" << endl;
+    return failed == 0 && run > 0 ? 0 : 1;
+}
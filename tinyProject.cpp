@@ -1,16 +1,36 @@
 #include "include/Vector.h"
 #include "include/Matrix.h"
 #include "include/LinearSystem.h"
+#include "include/MachineData.h"
+#include "include/DatasetCache.h"
+#include "include/NormalEquations.h"
+#include "include/Regression.h"
+#include "include/OutOfCore.h"
+#include "include/CrossValidation.h"
+#include "include/RidgeRegression.h"
+#include "include/ElasticNet.h"
+#include "include/OnlineRegression.h"
+#include "include/SgdTrainer.h"
+#include "include/Model.h"
+#include "include/Evaluation.h"
+#include "include/Bootstrap.h"
+#include "include/KNearestNeighbours.h"
+#include "include/FeatureExpansion.h"
+#include "include/OneHotRegression.h"
+#include "include/DatasetSplit.h"
+#include "include/SyntheticData.h"
+#include "include/Instrumentation.h"
+#include "include/Tracing.h"
 
 // File parsing
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <vector>
 
-#include <random> // for std::shuffle
-#include <algorithm> // for std::shuffle
-#include <ctime> // for seeding randomness
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
 
 #include <iostream>
 
@@ -18,118 +38,586 @@ using namespace std;
 
 void parse_csv(const string& filename,
                Matrix& X_train, Vector& Y_train,
-               Matrix& X_test, Vector& Y_test) {
-    ifstream file(filename);
-    string line;
+               Matrix& X_test, Vector& Y_test, uint64_t seed = 42) {
+    TP_TRACE_SCOPE("parse_csv");
+    // Columns come from the binary cache next to the CSV, rebuilt when the CSV changes
+    DatasetCache cache(filename, filename + ".tpcache");
+
+    std::cout << "Parsed " << cache.rows() << " rows." << std::endl;
+
+    // 80/20 split of a seeded index permutation; rows are read straight from the columns
+    DatasetSplit split(cache.rows(), 0.8, seed);
+    IndexView train = split.train(), test = split.test();
+
+    X_train = Matrix(train.size(), 6);
+    Y_train = Vector(train.size());
+    X_test = Matrix(test.size(), 6);
+    Y_test = Vector(test.size());
+
+    for (int j = 0; j < 6; ++j) {
+        const ColumnView& column = cache.column(j);
+        for (size_t i = 0; i < train.size(); ++i) X_train[i][j] = column[train[i]];
+        for (size_t i = 0; i < test.size(); ++i) X_test[i][j] = column[test[i]];
+    }
+    const ColumnView& prp = cache.column(MachineData::kNumFeatures);
+    for (size_t i = 0; i < train.size(); ++i) Y_train[i] = prp[train[i]];
+    for (size_t i = 0; i < test.size(); ++i) Y_test[i] = prp[test[i]];
+}
+
+// Trains on the whole file block by block within a memory budget (in MiB)
+// instead of loading it into a Matrix.
+void run_out_of_core(const string& filename, size_t budgetMiB) {
+    OutOfCoreTrainer trainer(budgetMiB << 20);
+    trainer.train(filename);
+
+    cout << "Streamed " << trainer.trainRows() << " training rows and "
+         << trainer.holdoutRows() << " holdout rows in "
+         << (trainer.blockBytes() >> 10) << " KiB blocks." << endl;
+
+    Vector weights = trainer.solve();
+    weights.print();
+    cout << "RMSE on holdout set: " << trainer.holdoutRmse(weights) << endl;
+}
 
-    // Skip header
-    if (!getline(file, line)) {
-        throw runtime_error("File is empty or missing header");
+// k-fold cross-validation with a fixed seed, so runs can be compared.
+void run_k_fold(const string& filename, int numFolds, uint64_t seed) {
+    MachineData data = read_machine_data(filename);
+    CrossValidationResult cv = k_fold_cross_validation(data, numFolds, seed);
+
+    for (int f = 0; f < numFolds; ++f) {
+        cout << "Fold " << f << " (" << cv.foldRows[f] << " rows): RMSE " << cv.foldRmse[f] << endl;
     }
+    cout << numFolds << "-fold RMSE: " << cv.rmse << " (mean of folds " << cv.meanRmse << ")" << endl;
+}
 
-    vector<std::vector<double>> features;
-    vector<double> targets;
+// Leave-one-out cross-validation from a single factorisation.
+void run_leave_one_out(const string& filename) {
+    MachineData data = read_machine_data(filename);
+    LeaveOneOutResult loo = leave_one_out(data);
 
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string token;
-        vector<string> tokens;
+    size_t worst = 0;
+    for (size_t i = 1; i < data.rows(); ++i) {
+        if (loo.leverage[i] > loo.leverage[worst]) worst = i;
+    }
+    cout << "Leave-one-out RMSE: " << loo.rmse << endl;
+    cout << "Highest leverage: row " << worst << " (h = " << loo.leverage[worst]
+         << ", LOO residual " << loo.residuals[worst] << ")" << endl;
+}
 
-        while (getline(ss, token, ',')) {
-            tokens.push_back(token);
-        }
+// Ridge path over 100 penalties, validated on a seeded 20% holdout.
+void run_ridge_path(const string& filename, uint64_t seed) {
+    MachineData data = read_machine_data(filename);
+    vector<int> fold = assign_folds(data.rows(), 5, seed);
 
-        if (tokens.size() != 10) continue;
+    NormalEquationsAccumulator train(MachineData::kNumFeatures), validation(MachineData::kNumFeatures);
+    for (size_t i = 0; i < data.rows(); ++i) {
+        (fold[i] == 0 ? validation : train).addRow(data.row(i), data.targets[i]);
+    }
 
-        try {
-            vector<double> x_row;
-            for (int i = 2; i <= 7; ++i) {
-                x_row.push_back(stod(tokens[i]));
-            }
-            double prp = stod(tokens[8]);
-
-            features.push_back(x_row);
-            targets.push_back(prp);
-        }
-        catch (const invalid_argument&) {
-            continue;
+    RidgePath path = ridge_path(train, validation, log_spaced_lambdas(1e-4, 1e4, 100));
+    cout << "Best lambda: " << path.lambdas[path.best]
+         << " (validation RMSE " << path.validationRmse[path.best]
+         << ", lambda " << path.lambdas.front() << " gives " << path.validationRmse.front() << ")" << endl;
+    path.weights[path.best].print();
+}
+
+// Replays the file row by row through recursive least squares: every row is
+// first predicted by the model built from the rows before it, then added.
+void run_online(const string& filename, double forgetting) {
+    MachineData data = read_machine_data(filename);
+    OnlineRegression model(MachineData::kNumFeatures, forgetting);
+
+    double sum_squared_error = 0.0;
+    size_t scored = 0;
+    for (size_t i = 0; i < data.rows(); ++i) {
+        if (model.nRows() >= static_cast<size_t>(2 * MachineData::kNumFeatures)) {
+            double diff = model.predict(data.row(i)) - data.targets[i];
+            sum_squared_error += diff * diff;
+            ++scored;
         }
+        model.addRow(data.row(i), data.targets[i]);
     }
 
-    std::cout << "Parsed " << features.size() << " rows." << std::endl;
+    cout << "Online RMSE (predict-then-update, " << scored << " rows): "
+         << sqrt(sum_squared_error / scored) << endl;
+    model.weights().print();
+}
 
-    vector<pair<vector<double>, double>> data;
-    for (size_t i = 0; i < features.size(); ++i) {
-        data.emplace_back(features[i], targets[i]);
+// Mini-batch gradient training with early stopping on the last 20% of the
+// training rows, compared with the exact fit on the test set.
+void run_sgd(const string& filename, const string& optimizer) {
+    Matrix X_train, X_test;
+    Vector Y_train, Y_test;
+    parse_csv(filename, X_train, Y_train, X_test, Y_test);
+
+    int fit_rows = X_train.nRows() * 4 / 5;
+    Matrix X_fit(fit_rows, X_train.nCols()), X_val(X_train.nRows() - fit_rows, X_train.nCols());
+    Vector Y_fit(fit_rows), Y_val(X_train.nRows() - fit_rows);
+    for (int i = 0; i < X_train.nRows(); ++i) {
+        Matrix& X = i < fit_rows ? X_fit : X_val;
+        Vector& Y = i < fit_rows ? Y_fit : Y_val;
+        int row = i < fit_rows ? i : i - fit_rows;
+        for (int j = 0; j < X_train.nCols(); ++j) X[row][j] = X_train[i][j];
+        Y[row] = Y_train[i];
     }
 
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(data.begin(), data.end(), g);
+    SgdOptions options;
+    if (optimizer == "sgd") options.optimizer = SgdOptimizer::Sgd;
+    else if (optimizer == "momentum") options.optimizer = SgdOptimizer::Momentum;
+    else if (optimizer != "adam") throw runtime_error("Unknown optimizer: " + optimizer);
+
+    SgdResult sgd = SgdTrainer(options).train(X_fit, Y_fit, X_val, Y_val);
+    Vector exact = solve_linear_regression(X_fit, Y_fit);
 
-    size_t total = data.size();
-    size_t train_size = static_cast<size_t>(total * 0.8);
+    cout << optimizer << " stopped after " << sgd.epochs << " epochs, validation RMSE "
+         << sgd.validationRmse << endl;
+    sgd.weights.print();
+    cout << "RMSE on test set: " << compute_rmse(predict(X_test, sgd.weights), Y_test)
+         << " (exact fit " << compute_rmse(predict(X_test, exact), Y_test) << ")" << endl;
+}
 
-    X_train = Matrix(train_size, 6);
-    Y_train = Vector(train_size);
-    X_test = Matrix(total - train_size, 6);
-    Y_test = Vector(total - train_size);
+// Elastic-net path on a seeded 80/20 split; alpha = 1 is the lasso.
+void run_elastic_net(const string& filename, double alpha, uint64_t seed) {
+    MachineData data = read_machine_data(filename);
+    vector<int> fold = assign_folds(data.rows(), 5, seed);
 
-    for (size_t i = 0; i < train_size; ++i) {
-        for (int j = 0; j < 6; ++j) {
-            X_train[i][j] = data[i].first[j];
-        }
-        Y_train[i] = data[i].second;
+    NormalEquationsAccumulator train(MachineData::kNumFeatures), validation(MachineData::kNumFeatures);
+    for (size_t i = 0; i < data.rows(); ++i) {
+        (fold[i] == 0 ? validation : train).addRow(data.row(i), data.targets[i]);
     }
 
-    for (size_t i = train_size; i < total; ++i) {
-        for (int j = 0; j < 6; ++j) {
-            X_test[i - train_size][j] = data[i].first[j];
-        }
-        Y_test[i - train_size] = data[i].second;
+    ElasticNetOptions options;
+    options.alpha = alpha;
+    ElasticNetPath path = elastic_net_path(train, options, &validation);
+
+    cout << "Best lambda: " << path.lambdas[path.best] << " with " << path.nonZeros[path.best]
+         << " non-zero weights (validation RMSE " << path.validationRmse[path.best] << ")" << endl;
+    path.weights[path.best].print();
+}
+
+// Fits on every row and writes the model for tinyScore.
+void run_train_model(const string& filename, const string& modelPath) {
+    MachineData data = read_machine_data(filename);
+    NormalEquationsAccumulator normal(MachineData::kNumFeatures);
+    normal.addRows(data.features.data(), data.targets.data(), data.rows());
+
+    vector<string> names(MachineData::kColumnNames, MachineData::kColumnNames + MachineData::kNumFeatures);
+    Model model(names, normal.solve());
+    model.save(modelPath);
+    cout << "Model trained on " << data.rows() << " rows written to " << modelPath << endl;
+}
+
+void run_bootstrap(const string& filename, int replicates, uint64_t seed) {
+    MachineData data = read_machine_data(filename);
+    BootstrapResult boot = bootstrap_weights(data, replicates, 0.95, seed);
+
+    cout << boot.replicates << " bootstrap replicates (" << boot.failed << " singular), 95% percentile intervals:" << endl;
+    for (int j = 0; j < MachineData::kNumFeatures; ++j) {
+        cout << MachineData::kColumnNames[j] << ": " << boot.estimate[j]
+             << " [" << boot.lower[j] << ", " << boot.upper[j] << "], standard error " << boot.standardError[j] << endl;
     }
 }
 
-Vector solve_linear_regression(Matrix& X, Vector& Y) {
-    // Step 1: Transpose X
-    Matrix Xt = X.transpose();
+// Instance-based prediction against linear regression on the same split:
+// fold 0 of a seeded 5-fold assignment is held out.
+void run_knn(const string& filename, int k) {
+    MachineData data = read_machine_data(filename);
+    vector<int> fold = assign_folds(data.rows(), 5, 42);
+
+    MachineData train, test;
+    for (size_t i = 0; i < data.rows(); ++i) {
+        MachineData& part = fold[i] == 0 ? test : train;
+        part.features.insert(part.features.end(), data.row(i), data.row(i) + MachineData::kNumFeatures);
+        part.targets.push_back(data.targets[i]);
+    }
 
-    // Step 2: Xt * X
-    Matrix XtX = Xt * X;
+    KNearestNeighbours knn(train, k);
+    vector<double> predicted = knn.predict(test.features.data(), test.rows());
+    double sse = 0.0;
+    for (size_t i = 0; i < test.rows(); ++i) {
+        sse += (predicted[i] - test.targets[i]) * (predicted[i] - test.targets[i]);
+    }
 
-    // Step 3: (Xt * X)^-1
-    Matrix XtX_inv = XtX.inverse();
+    NormalEquationsAccumulator normal(MachineData::kNumFeatures);
+    normal.addRows(train.features.data(), train.targets.data(), train.rows());
+    vector<string> names(MachineData::kColumnNames, MachineData::kColumnNames + MachineData::kNumFeatures);
+    RegressionMetrics linear = evaluate_regression(test, Model(names, normal.solve()));
 
-    // Step 4: Xt * Y
-    Vector XtY = Xt * Y;
+    cout << k << "-NN test RMSE: " << sqrt(sse / test.rows())
+         << " (linear regression: " << linear.rmse << ", " << test.rows() << " test rows)" << endl;
+}
 
-    // Step 5: (XtX)^-1 * XtY
-    Vector result = XtX_inv * XtY;
+// Polynomial (and optionally log) expansion fitted on folds 1-4 of a seeded
+// 5-fold assignment and scored on fold 0.
+void run_expansion(const string& filename, int degree, bool logs) {
+    MachineData data = read_machine_data(filename);
+    vector<int> fold = assign_folds(data.rows(), 5, 42);
+
+    MachineData train, test;
+    for (size_t i = 0; i < data.rows(); ++i) {
+        MachineData& part = fold[i] == 0 ? test : train;
+        part.features.insert(part.features.end(), data.row(i), data.row(i) + MachineData::kNumFeatures);
+        part.targets.push_back(data.targets[i]);
+    }
 
-    return result;
+    ExpansionOptions options;
+    options.degree = degree;
+    options.logFeatures = logs;
+    options.logTarget = logs;
+    FeatureExpansion expansion(options, train);
+    NormalEquationsAccumulator normal = accumulate_expanded(expansion, train);
+
+    double trace = 0.0;
+    for (int j = 0; j < expansion.nTerms(); ++j) trace += normal.gramData()[j * expansion.nTerms() + j];
+    Vector weights = solve_expanded(normal, 1e-4 * trace / expansion.nTerms());
+
+    double sse = 0.0;
+    for (size_t i = 0; i < test.rows(); ++i) {
+        double e = expansion.predict(test.row(i), weights) - test.targets[i];
+        sse += e * e;
+    }
+    cout << expansion.nTerms() << " expanded terms (degree " << degree << (logs ? ", logs" : "")
+         << "), test RMSE: " << sqrt(sse / test.rows()) << " on " << test.rows() << " rows" << endl;
 }
 
-Vector predict(Matrix& X, Vector& weights) {
-    return X * weights;
+// Numeric predictors plus one-hot vendor offsets against the numeric-only fit,
+// trained on folds 1-4 of a seeded 5-fold assignment and scored on fold 0.
+void run_vendor(const string& filename) {
+    MachineData data = read_machine_data(filename);
+    vector<int> fold = assign_folds(data.rows(), 5, 42);
+
+    OneHotNormalEquations train(MachineData::kNumFeatures, static_cast<int>(data.vendorNames.size()));
+    NormalEquationsAccumulator numeric(MachineData::kNumFeatures);
+    for (size_t i = 0; i < data.rows(); ++i) {
+        if (fold[i] == 0) continue;
+        train.addRow(data.row(i), data.vendors[i], data.targets[i]);
+        numeric.addRow(data.row(i), data.targets[i]);
+    }
+    OneHotFit fit = train.solve();
+    Vector weights = numeric.solve();
+
+    double sse = 0.0, sseNumeric = 0.0;
+    size_t tested = 0;
+    for (size_t i = 0; i < data.rows(); ++i) {
+        if (fold[i] != 0) continue;
+        double e = fit.predict(data.row(i), data.vendors[i]) - data.targets[i];
+        double en = -data.targets[i];
+        for (int j = 0; j < MachineData::kNumFeatures; ++j) en += weights[j] * data.row(i)[j];
+        sse += e * e;
+        sseNumeric += en * en;
+        ++tested;
+    }
+    cout << data.vendorNames.size() << " vendors one-hot encoded, test RMSE: " << sqrt(sse / tested)
+         << " (numeric predictors only: " << sqrt(sseNumeric / tested) << ", " << tested << " test rows)" << endl;
 }
 
-double compute_rmse(const Vector& predicted, const Vector& actual) {
-    if (predicted.size() != actual.size()) {
-        throw runtime_error("Vectors must be the same size for RMSE calculation.");
+// PRP and ERP fitted together from one factorisation of XᵀX and scored in one
+// pass over the test rows. Both targets share the factorisation, so a row
+// whose ERP could not be read is left out of the fit and the scoring.
+void run_multi_target(const string& filename, uint64_t seed) {
+    MachineData data = read_machine_data(filename);
+    DatasetSplit split(data.rows(), 0.8, seed);
+    vector<size_t> train, test;
+    for (size_t i : split.train()) {
+        if (isfinite(data.targets[i]) && isfinite(data.erp[i])) train.push_back(i);
+    }
+    for (size_t i : split.test()) {
+        if (isfinite(data.targets[i]) && isfinite(data.erp[i])) test.push_back(i);
+    }
+    size_t skipped = data.rows() - train.size() - test.size();
+    if (skipped > 0) cout << skipped << " rows without a readable ERP left out." << endl;
+
+    Matrix X_train(train.size(), MachineData::kNumFeatures), Y_train(train.size(), 2);
+    Matrix X_test(test.size(), MachineData::kNumFeatures), Y_test(test.size(), 2);
+    for (size_t i = 0; i < train.size(); ++i) {
+        copy(data.row(train[i]), data.row(train[i]) + MachineData::kNumFeatures, X_train[i]);
+        Y_train[i][0] = data.targets[train[i]];
+        Y_train[i][1] = data.erp[train[i]];
+    }
+    for (size_t i = 0; i < test.size(); ++i) {
+        copy(data.row(test[i]), data.row(test[i]) + MachineData::kNumFeatures, X_test[i]);
+        Y_test[i][0] = data.targets[test[i]];
+        Y_test[i][1] = data.erp[test[i]];
     }
 
-    double sum_squared_error = 0.0;
-    for (int i = 0; i < predicted.size(); ++i) {
-        double diff = predicted[i] - actual[i];
-        sum_squared_error += diff * diff;
+    Matrix W = solve_linear_regression(X_train, Y_train);
+    vector<RegressionMetrics> metrics = evaluate_regression(X_test, Y_test, W);
+    const char* targets[2] = {"PRP", "ERP"};
+    for (int t = 0; t < 2; ++t) {
+        cout << targets[t] << ": test RMSE " << metrics[t].rmse << ", MAE " << metrics[t].mae
+             << ", R^2 " << metrics[t].r2 << ", weights";
+        for (int j = 0; j < MachineData::kNumFeatures; ++j) cout << " " << W[j][t];
+        cout << endl;
     }
+}
 
-    return sqrt(sum_squared_error / predicted.size());
+// Synthetic rows in the machine.data schema: a dataset cache when the path
+// ends in .tpcache, CSV otherwise.
+void run_generate(size_t rows, const string& path, uint64_t seed) {
+    auto start = chrono::steady_clock::now();
+    bool cache = path.size() > 8 && path.compare(path.size() - 8, 8, ".tpcache") == 0;
+    if (cache) write_synthetic_cache(path, rows, seed);
+    else write_synthetic_csv(path, rows, seed);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    double mb = filesystem::file_size(path) / 1e6;
+    cout << rows << " synthetic rows (seed " << seed << ") written to " << path << ": "
+         << mb << " MB in " << seconds << " s, " << mb / seconds << " MB/s" << endl;
 }
 
+// The textbook solvers on the Part B split, profiled by the Matrix/Vector
+// instrumentation: the normal equations by Gaussian elimination and by CG,
+// the Moore-Penrose solution, and their test RMSE. Prints the per-operation
+// table, or writes it as JSON when a path is given.
+void run_instrumented(const string& filename, const string& jsonPath) {
+    if (!kInstrumentationEnabled)
+        throw runtime_error("tinyProject was built without TINYPROJECT_INSTRUMENT.");
+
+    Matrix X_train, X_test;
+    Vector Y_train, Y_test;
+    parse_csv(filename, X_train, Y_train, X_test, Y_test);
+    instrumentation_reset();
+
+    Matrix Xt = X_train.transpose();
+    Matrix XtX = Xt * X_train;
+    Vector XtY = Xt * Y_train;
+    LinearSystem gauss(XtX, XtY);
+    PosSymLinSystem cg(XtX, XtY);
+    GeneralLinSystem pinv(X_train, Y_train);
+    Vector solutions[3] = {gauss.Solve(), cg.Solve(), pinv.SolveMoorePenrose()};
+    const char* names[3] = {"Gaussian elimination", "conjugate gradient", "Moore-Penrose"};
+    for (int s = 0; s < 3; ++s) {
+        Vector residual = X_test * solutions[s] - Y_test;
+        cout << names[s] << ": test RMSE " << sqrt(residual * residual / residual.size()) << endl;
+    }
+
+    InstrumentationSnapshot snapshot = instrumentation_snapshot();
+    if (jsonPath.empty()) {
+        snapshot.printTable(cout);
+        return;
+    }
+    ofstream out(jsonPath);
+    snapshot.writeJson(out);
+    if (!out)
+        throw runtime_error("Could not write file: " + jsonPath);
+    cout << "Instrumentation written to " << jsonPath << endl;
+}
 
-int main()
+// The Part B pipeline, a parallel pass over the whole file and the textbook
+// solvers on the normal equations, recorded as a Chrome trace. Point it at a
+// large --generate file to see the parse and evaluation chunks overlap.
+void run_traced(const string& filename, const string& tracePath) {
+    if (!kTracingEnabled)
+        throw runtime_error("tinyProject was built without TINYPROJECT_TRACE.");
+
+    Matrix X_train, X_test;
+    Vector Y_train, Y_test;
+    parse_csv(filename, X_train, Y_train, X_test, Y_test);
+    Vector weights = solve_linear_regression(X_train, Y_train);
+    Vector predicted = predict(X_test, weights);
+    cout << "RMSE on test set: " << compute_rmse(predicted, Y_test) << endl;
+    evaluate_regression(X_test, Y_test, weights);
+
+    NormalEquationsAccumulator normal = accumulate_machine_data(filename);
+    normal.solve();
+
+    Matrix Xt = X_train.transpose();
+    Matrix XtX = Xt * X_train;
+    Vector XtY = Xt * Y_train;
+    LinearSystem gauss(XtX, XtY);
+    PosSymLinSystem cg(XtX, XtY);
+    gauss.Solve();
+    cg.Solve();
+
+    size_t events = write_chrome_trace(tracePath);
+    cout << events << " trace events written to " << tracePath;
+    if (uint64_t dropped = trace_dropped_events()) cout << " (" << dropped << " dropped)";
+    cout << endl;
+}
+
+int main(int argc, char* argv[])
 {
+    // tinyProject --out-of-core [file] [budget MiB]
+    if (argc > 1 && string(argv[1]) == "--out-of-core") {
+        try {
+            run_out_of_core(argc > 2 ? argv[2] : "data/machine.data",
+                            argc > 3 ? stoul(argv[3]) : 64);
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --kfold [k] [seed]
+    if (argc > 1 && string(argv[1]) == "--kfold") {
+        try {
+            run_k_fold("data/machine.data", argc > 2 ? stoi(argv[2]) : 5, argc > 3 ? stoull(argv[3]) : 42);
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --loocv
+    if (argc > 1 && string(argv[1]) == "--loocv") {
+        try {
+            run_leave_one_out("data/machine.data");
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --ridge [seed]
+    if (argc > 1 && string(argv[1]) == "--ridge") {
+        try {
+            run_ridge_path("data/machine.data", argc > 2 ? stoull(argv[2]) : 42);
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --online [forgetting factor]
+    if (argc > 1 && string(argv[1]) == "--online") {
+        try {
+            run_online("data/machine.data", argc > 2 ? stod(argv[2]) : 1.0);
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --sgd [sgd|momentum|adam]
+    if (argc > 1 && string(argv[1]) == "--sgd") {
+        try {
+            run_sgd("data/machine.data", argc > 2 ? argv[2] : "adam");
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --enet [alpha] [seed]
+    if (argc > 1 && string(argv[1]) == "--enet") {
+        try {
+            run_elastic_net("data/machine.data", argc > 2 ? stod(argv[2]) : 1.0, argc > 3 ? stoull(argv[3]) : 42);
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --train-model [model path]
+    if (argc > 1 && string(argv[1]) == "--train-model") {
+        try {
+            run_train_model("data/machine.data", argc > 2 ? argv[2] : "data/machine.tpmodel");
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --bootstrap [replicates] [seed]
+    if (argc > 1 && string(argv[1]) == "--bootstrap") {
+        try {
+            run_bootstrap("data/machine.data", argc > 2 ? stoi(argv[2]) : 1000, argc > 3 ? stoull(argv[3]) : 42);
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --knn [k]
+    if (argc > 1 && string(argv[1]) == "--knn") {
+        try {
+            run_knn("data/machine.data", argc > 2 ? stoi(argv[2]) : 3);
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --expand [degree] [log]
+    if (argc > 1 && string(argv[1]) == "--expand") {
+        try {
+            run_expansion("data/machine.data", argc > 2 ? stoi(argv[2]) : 2, argc > 3 && string(argv[3]) == "log");
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --vendor
+    if (argc > 1 && string(argv[1]) == "--vendor") {
+        try {
+            run_vendor("data/machine.data");
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --multi-target [seed]
+    if (argc > 1 && string(argv[1]) == "--multi-target") {
+        try {
+            run_multi_target("data/machine.data", argc > 2 ? stoull(argv[2]) : 42);
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --generate <rows> <path> [seed]
+    if (argc > 1 && string(argv[1]) == "--generate") {
+        try {
+            if (argc < 4)
+                throw runtime_error("Usage: tinyProject --generate <rows> <path> [seed]");
+            run_generate(stoull(argv[2]), argv[3], argc > 4 ? stoull(argv[4]) : 42);
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --instrument [json path]
+    if (argc > 1 && string(argv[1]) == "--instrument") {
+        try {
+            run_instrumented("data/machine.data", argc > 2 ? argv[2] : "");
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // tinyProject --trace <path> [data file]
+    if (argc > 1 && string(argv[1]) == "--trace") {
+        try {
+            if (argc < 3)
+                throw runtime_error("Usage: tinyProject --trace <path> [data file]");
+            run_traced(argc > 3 ? argv[3] : "data/machine.data", argv[2]);
+        } catch (const exception& e) {
+            cerr << "Exception: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+
     {// Part A
     // 1.
     /*
@@ -340,10 +828,10 @@ int main()
         // Print weights
         weights.print();
 
-        Vector Y_pred = predict(X_test, weights);
-
-        double rmse = compute_rmse(Y_pred, Y_test);
-        cout << "RMSE on test set: " << rmse << std::endl;
+        // Predictions and every metric in one pass over the test set
+        RegressionMetrics metrics = evaluate_regression(X_test, Y_test, weights);
+        cout << "RMSE on test set: " << metrics.rmse << std::endl;
+        cout << "MAE: " << metrics.mae << ", R^2: " << metrics.r2 << ", max error: " << metrics.maxError << std::endl;
 
         for (int i = 0; i < weights.size(); ++i) {
             cout << "Weight " << i << ": " << weights[i] << std::endl;
@@ -0,0 +1,66 @@
+#include "include/Model.h"
+#include "include/ScoringEngine.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+using namespace std;
+
+// Standalone scoring engine:
+//   tinyScore <model> [features|-] [--csv] [--text|--binary]
+// Reads float64 feature rows (or CSV lines with --csv) from a file, which is
+// memory-mapped, or from stdin ("-" or no file), and writes one prediction
+// per row to stdout: float64 for binary input, text for CSV unless overridden.
+// Throughput goes to stderr.
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        cerr << "Usage: tinyScore <model> [features|-] [--csv] [--text|--binary]" << endl;
+        return 2;
+    }
+
+    string input = "-";
+    FeatureFormat format = FeatureFormat::Binary;
+    int textOutput = -1;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--csv") == 0) format = FeatureFormat::Csv;
+        else if (strcmp(argv[i], "--text") == 0) textOutput = 1;
+        else if (strcmp(argv[i], "--binary") == 0) textOutput = 0;
+        else input = argv[i];
+    }
+    if (textOutput < 0) textOutput = format == FeatureFormat::Csv;
+
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    ios::sync_with_stdio(false);
+
+    try {
+        Model model = Model::load(argv[1]);
+        ScoringEngine engine(model);
+
+        auto start = chrono::steady_clock::now();
+        size_t rows = input == "-" ? engine.scoreStream(cin, format, cout, textOutput)
+                                   : engine.scoreFile(input, format, cout, textOutput);
+        cout.flush();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cerr << "Scored " << rows << " rows in " << seconds << " s";
+        if (format == FeatureFormat::Binary && seconds > 0.0) {
+            cerr << " (" << rows * model.nFeatures() * sizeof(double) / seconds / 1e9 << " GB/s)";
+        }
+        cerr << endl;
+    } catch (const exception& e) {
+        cerr << "Exception: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}